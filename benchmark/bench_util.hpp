@@ -0,0 +1,89 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#ifndef BENCH_UTIL_HPP_
+#define BENCH_UTIL_HPP_
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace datasketches {
+
+// fixed seed so that every run sees the same input
+static const uint64_t BENCH_SEED = 12345;
+
+// stream lengths shared by all update benchmarks
+static const std::vector<int64_t> BENCH_STREAM_LENGTHS = {1 << 10, 1 << 16, 1 << 20};
+
+template<typename T>
+std::vector<T> make_uniform_values(size_t n, uint64_t seed = BENCH_SEED) {
+  std::mt19937_64 gen(seed);
+  std::uniform_real_distribution<T> dist(0, 1);
+  std::vector<T> values(n);
+  for (auto& value: values) value = dist(gen);
+  return values;
+}
+
+static inline std::vector<uint64_t> make_distinct_values(size_t n, uint64_t seed = BENCH_SEED) {
+  std::mt19937_64 gen(seed);
+  std::vector<uint64_t> values(n);
+  for (auto& value: values) value = gen();
+  return values;
+}
+
+// Zipf-like skewed stream over a given number of distinct keys
+static inline std::vector<uint64_t> make_skewed_values(size_t n, size_t num_distinct, uint64_t seed = BENCH_SEED) {
+  std::mt19937_64 gen(seed);
+  std::exponential_distribution<double> dist(10.0 / num_distinct);
+  std::vector<uint64_t> values(n);
+  for (auto& value: values) value = static_cast<uint64_t>(dist(gen)) % num_distinct;
+  return values;
+}
+
+// skewed values where a few hot values make up 30% of the stream
+static inline std::vector<uint64_t> make_hot_key_values(size_t n, size_t num_distinct, uint64_t seed = BENCH_SEED) {
+  std::vector<uint64_t> values = make_skewed_values(n, num_distinct, seed);
+  std::mt19937_64 gen(seed + 1);
+  std::uniform_int_distribution<int> dist(0, 99);
+  for (auto& value: values) {
+    const int r = dist(gen);
+    if (r < 30) value = num_distinct + r % 4;
+  }
+  return values;
+}
+
+static inline std::vector<std::string> to_strings(const std::vector<uint64_t>& values) {
+  std::vector<std::string> strings;
+  strings.reserve(values.size());
+  for (auto value: values) strings.push_back(std::to_string(value));
+  return strings;
+}
+
+static inline void set_items_processed(benchmark::State& state, int64_t items_per_iteration) {
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * items_per_iteration);
+}
+
+} /* namespace datasketches */
+
+#endif
@@ -0,0 +1,95 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <cpc_sketch.hpp>
+#include <cpc_union.hpp>
+
+#include "bench_util.hpp"
+
+namespace datasketches {
+
+static cpc_sketch make_cpc_sketch(uint8_t lg_k, size_t n, uint64_t seed = BENCH_SEED) {
+  cpc_sketch sketch(lg_k);
+  for (uint64_t value: make_distinct_values(n, seed)) sketch.update(value);
+  return sketch;
+}
+
+// args: lg_k, stream length
+static void BM_cpc_update(benchmark::State& state) {
+  const uint8_t lg_k = state.range(0);
+  const auto values = make_distinct_values(state.range(1));
+  for (auto _: state) {
+    cpc_sketch sketch(lg_k);
+    for (uint64_t value: values) sketch.update(value);
+    benchmark::DoNotOptimize(sketch.get_estimate());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_cpc_update)->ArgsProduct({{10, 12, 16, 20}, BENCH_STREAM_LENGTHS});
+
+// args: lg_k, stream length
+static void BM_cpc_update_batch(benchmark::State& state) {
+  const uint8_t lg_k = state.range(0);
+  const auto values = make_distinct_values(state.range(1));
+  for (auto _: state) {
+    cpc_sketch sketch(lg_k);
+    sketch.update_batch(values.data(), values.size());
+    benchmark::DoNotOptimize(sketch.get_estimate());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_cpc_update_batch)->ArgsProduct({{10, 12, 16, 20}, BENCH_STREAM_LENGTHS});
+
+// args: lg_k, number of sketches
+static void BM_cpc_union(benchmark::State& state) {
+  const uint8_t lg_k = state.range(0);
+  std::vector<cpc_sketch> sketches;
+  for (int64_t i = 0; i < state.range(1); ++i) sketches.push_back(make_cpc_sketch(lg_k, 1 << 16, BENCH_SEED + i));
+  for (auto _: state) {
+    cpc_union u(lg_k);
+    for (const auto& sketch: sketches) u.update(sketch);
+    benchmark::DoNotOptimize(u.get_result().get_estimate());
+  }
+  set_items_processed(state, sketches.size());
+}
+BENCHMARK(BM_cpc_union)->ArgsProduct({{10, 12, 16}, {16, 64}});
+
+// args: lg_k, stream length
+static void BM_cpc_serialize(benchmark::State& state) {
+  const auto sketch = make_cpc_sketch(state.range(0), state.range(1));
+  for (auto _: state) {
+    auto bytes = sketch.serialize();
+    benchmark::DoNotOptimize(bytes.data());
+  }
+}
+BENCHMARK(BM_cpc_serialize)->ArgsProduct({{10, 12, 16}, BENCH_STREAM_LENGTHS});
+
+// args: lg_k, stream length
+static void BM_cpc_deserialize(benchmark::State& state) {
+  const auto bytes = make_cpc_sketch(state.range(0), state.range(1)).serialize();
+  for (auto _: state) {
+    auto sketch = cpc_sketch::deserialize(bytes.data(), bytes.size());
+    benchmark::DoNotOptimize(sketch.get_estimate());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * bytes.size());
+}
+BENCHMARK(BM_cpc_deserialize)->ArgsProduct({{10, 12, 16}, BENCH_STREAM_LENGTHS});
+
+} /* namespace datasketches */
@@ -0,0 +1,158 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <frequent_items_sketch.hpp>
+#include <sharded_frequent_items_sketch.hpp>
+
+#include "bench_util.hpp"
+
+namespace datasketches {
+
+static const size_t FI_NUM_DISTINCT = 1 << 20;
+
+template<typename T>
+static frequent_items_sketch<T> make_fi_sketch(uint8_t lg_max_map_size, const std::vector<T>& values) {
+  frequent_items_sketch<T> sketch(lg_max_map_size);
+  for (const auto& value: values) sketch.update(value);
+  return sketch;
+}
+
+// args: lg_max_map_size, stream length
+static void BM_fi_update(benchmark::State& state) {
+  const uint8_t lg_max_map_size = state.range(0);
+  const auto values = make_skewed_values(state.range(1), FI_NUM_DISTINCT);
+  for (auto _: state) {
+    frequent_items_sketch<uint64_t> sketch(lg_max_map_size);
+    for (uint64_t value: values) sketch.update(value);
+    benchmark::DoNotOptimize(sketch.get_total_weight());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_fi_update)->ArgsProduct({{10, 16, 20}, BENCH_STREAM_LENGTHS});
+
+// args: lg_max_map_size, stream length
+static void BM_fi_update_string(benchmark::State& state) {
+  const uint8_t lg_max_map_size = state.range(0);
+  const auto values = to_strings(make_skewed_values(state.range(1), FI_NUM_DISTINCT));
+  for (auto _: state) {
+    frequent_items_sketch<std::string> sketch(lg_max_map_size);
+    for (const auto& value: values) sketch.update(value);
+    benchmark::DoNotOptimize(sketch.get_total_weight());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_fi_update_string)->ArgsProduct({{10, 16, 20}, BENCH_STREAM_LENGTHS});
+
+// args: lg_max_map_size, stream length
+static void BM_fi_update_batch(benchmark::State& state) {
+  const uint8_t lg_max_map_size = state.range(0);
+  const auto values = make_skewed_values(state.range(1), FI_NUM_DISTINCT);
+  for (auto _: state) {
+    frequent_items_sketch<uint64_t> sketch(lg_max_map_size);
+    sketch.update(values.data(), nullptr, values.size());
+    benchmark::DoNotOptimize(sketch.get_total_weight());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_fi_update_batch)->ArgsProduct({{10, 16, 20}, BENCH_STREAM_LENGTHS});
+
+// args: lg_max_map_size, stream length
+static void BM_fi_update_string_batch(benchmark::State& state) {
+  const uint8_t lg_max_map_size = state.range(0);
+  const auto values = to_strings(make_skewed_values(state.range(1), FI_NUM_DISTINCT));
+  for (auto _: state) {
+    frequent_items_sketch<std::string> sketch(lg_max_map_size);
+    sketch.update(values.data(), nullptr, values.size());
+    benchmark::DoNotOptimize(sketch.get_total_weight());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_fi_update_string_batch)->ArgsProduct({{10, 16, 20}, BENCH_STREAM_LENGTHS});
+
+// args: lg_max_map_size, batched (0 or 1)
+static void BM_fi_update_string_hot_keys(benchmark::State& state) {
+  const uint8_t lg_max_map_size = state.range(0);
+  const bool batched = state.range(1) != 0;
+  const auto values = to_strings(make_hot_key_values(1 << 20, FI_NUM_DISTINCT));
+  for (auto _: state) {
+    frequent_items_sketch<std::string> sketch(lg_max_map_size);
+    if (batched) {
+      sketch.update(values.data(), nullptr, values.size());
+    } else {
+      for (const auto& value: values) sketch.update(value);
+    }
+    benchmark::DoNotOptimize(sketch.get_total_weight());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_fi_update_string_hot_keys)->ArgsProduct({{10, 16, 20}, {0, 1}});
+
+// args: lg_max_map_size, number of threads (and shards)
+static void BM_fi_sharded_update_batch(benchmark::State& state) {
+  const uint8_t lg_max_map_size = state.range(0);
+  const unsigned num_threads = state.range(1);
+  const auto values = make_hot_key_values(1 << 20, FI_NUM_DISTINCT);
+  for (auto _: state) {
+    sharded_frequent_items_sketch<uint64_t> sketch(lg_max_map_size, num_threads);
+    sketch.update(values.data(), nullptr, values.size(), num_threads);
+    benchmark::DoNotOptimize(sketch.get_result().get_maximum_error());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_fi_sharded_update_batch)->ArgsProduct({{10, 16, 20}, {1, 2, 4}})->UseRealTime();
+
+// args: lg_max_map_size, number of sketches
+static void BM_fi_merge(benchmark::State& state) {
+  const uint8_t lg_max_map_size = state.range(0);
+  std::vector<frequent_items_sketch<uint64_t>> sketches;
+  for (int64_t i = 0; i < state.range(1); ++i) {
+    sketches.push_back(make_fi_sketch(lg_max_map_size, make_skewed_values(1 << 16, FI_NUM_DISTINCT, BENCH_SEED + i)));
+  }
+  for (auto _: state) {
+    frequent_items_sketch<uint64_t> sketch(lg_max_map_size);
+    for (const auto& other: sketches) sketch.merge(other);
+    benchmark::DoNotOptimize(sketch.get_total_weight());
+  }
+  set_items_processed(state, sketches.size());
+}
+BENCHMARK(BM_fi_merge)->ArgsProduct({{10, 16}, {16, 64}});
+
+// args: lg_max_map_size
+static void BM_fi_serialize(benchmark::State& state) {
+  const auto sketch = make_fi_sketch(state.range(0), make_skewed_values(1 << 20, FI_NUM_DISTINCT));
+  for (auto _: state) {
+    auto bytes = sketch.serialize();
+    benchmark::DoNotOptimize(bytes.data());
+  }
+}
+BENCHMARK(BM_fi_serialize)->Arg(10)->Arg(16)->Arg(20);
+
+// args: lg_max_map_size
+static void BM_fi_deserialize(benchmark::State& state) {
+  const auto bytes = make_fi_sketch(state.range(0), make_skewed_values(1 << 20, FI_NUM_DISTINCT)).serialize();
+  for (auto _: state) {
+    auto sketch = frequent_items_sketch<uint64_t>::deserialize(bytes.data(), bytes.size());
+    benchmark::DoNotOptimize(sketch.get_total_weight());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * bytes.size());
+}
+BENCHMARK(BM_fi_deserialize)->Arg(10)->Arg(16)->Arg(20);
+
+} /* namespace datasketches */
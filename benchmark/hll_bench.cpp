@@ -0,0 +1,159 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <hll.hpp>
+
+#include "bench_util.hpp"
+
+namespace datasketches {
+
+// benchmark args encode the target type as the number of bits per register
+static target_hll_type hll_type_from_arg(int64_t bits) {
+  return bits == 4 ? HLL_4 : bits == 6 ? HLL_6 : HLL_8;
+}
+
+static hll_sketch make_hll_sketch(uint8_t lg_k, target_hll_type type, size_t n, uint64_t seed = BENCH_SEED) {
+  hll_sketch sketch(lg_k, type);
+  for (uint64_t value: make_distinct_values(n, seed)) sketch.update(value);
+  return sketch;
+}
+
+// args: type, lg_k, stream length
+static void BM_hll_update(benchmark::State& state) {
+  const target_hll_type type = hll_type_from_arg(state.range(0));
+  const uint8_t lg_k = state.range(1);
+  const auto values = make_distinct_values(state.range(2));
+  for (auto _: state) {
+    hll_sketch sketch(lg_k, type);
+    for (uint64_t value: values) sketch.update(value);
+    benchmark::DoNotOptimize(sketch.get_estimate());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_hll_update)->ArgsProduct({{4, 6, 8}, {12, 16, 21}, BENCH_STREAM_LENGTHS});
+
+// args: type, lg_k, stream length
+static void BM_hll_update_batch(benchmark::State& state) {
+  const target_hll_type type = hll_type_from_arg(state.range(0));
+  const uint8_t lg_k = state.range(1);
+  const auto values = make_distinct_values(state.range(2));
+  for (auto _: state) {
+    hll_sketch sketch(lg_k, type);
+    sketch.update_batch(values.data(), values.size());
+    benchmark::DoNotOptimize(sketch.get_estimate());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_hll_update_batch)->ArgsProduct({{4, 6, 8}, {12, 16, 21}, BENCH_STREAM_LENGTHS});
+
+// args: type, lg_k, number of sketches
+static void BM_hll_union(benchmark::State& state) {
+  const target_hll_type type = hll_type_from_arg(state.range(0));
+  const uint8_t lg_k = state.range(1);
+  std::vector<hll_sketch> sketches;
+  for (int64_t i = 0; i < state.range(2); ++i) sketches.push_back(make_hll_sketch(lg_k, type, 1 << 18, BENCH_SEED + i));
+  for (auto _: state) {
+    hll_union u(lg_k);
+    for (const auto& sketch: sketches) u.update(sketch);
+    benchmark::DoNotOptimize(u.get_estimate());
+  }
+  set_items_processed(state, sketches.size());
+}
+BENCHMARK(BM_hll_union)->ArgsProduct({{4, 6, 8}, {12, 16}, {16, 64}});
+
+// args: lg_k, number of sketches, number of threads
+static void BM_hll_union_update_all(benchmark::State& state) {
+  const uint8_t lg_k = state.range(0);
+  std::vector<hll_sketch> sketches;
+  for (int64_t i = 0; i < state.range(1); ++i) sketches.push_back(make_hll_sketch(lg_k, HLL_8, 1 << 18, BENCH_SEED + i));
+  for (auto _: state) {
+    hll_union u(lg_k);
+    u.update_all(sketches.begin(), sketches.end(), state.range(2));
+    benchmark::DoNotOptimize(u.get_estimate());
+  }
+  set_items_processed(state, sketches.size());
+}
+BENCHMARK(BM_hll_union_update_all)->ArgsProduct({{16, 21}, {64}, {1, 2, 4}})->UseRealTime();
+
+static std::vector<hll_sketch::vector_bytes> make_serialized_hll_sketches(const benchmark::State& state) {
+  const target_hll_type type = hll_type_from_arg(state.range(0));
+  const uint8_t lg_k = state.range(1);
+  std::vector<hll_sketch::vector_bytes> blobs;
+  for (int64_t i = 0; i < state.range(2); ++i) {
+    blobs.push_back(make_hll_sketch(lg_k, type, 1 << 18, BENCH_SEED + i).serialize_compact());
+  }
+  return blobs;
+}
+
+// args: type, lg_k, number of sketches
+static void BM_hll_union_deserialize_and_update(benchmark::State& state) {
+  const auto blobs = make_serialized_hll_sketches(state);
+  for (auto _: state) {
+    hll_union u(state.range(1));
+    for (const auto& blob: blobs) u.update(hll_sketch::deserialize(blob.data(), blob.size()));
+    benchmark::DoNotOptimize(u.get_estimate());
+  }
+  set_items_processed(state, blobs.size());
+}
+BENCHMARK(BM_hll_union_deserialize_and_update)->ArgsProduct({{4, 6, 8}, {12, 16}, {16, 64}});
+
+// args: type, lg_k, number of sketches
+static void BM_hll_union_update_serialized(benchmark::State& state) {
+  const auto blobs = make_serialized_hll_sketches(state);
+  for (auto _: state) {
+    hll_union u(state.range(1));
+    for (const auto& blob: blobs) u.update_serialized(blob.data(), blob.size());
+    benchmark::DoNotOptimize(u.get_estimate());
+  }
+  set_items_processed(state, blobs.size());
+}
+BENCHMARK(BM_hll_union_update_serialized)->ArgsProduct({{4, 6, 8}, {12, 16}, {16, 64}});
+
+// args: type, lg_k
+static void BM_hll_get_estimate(benchmark::State& state) {
+  const auto sketch = make_hll_sketch(state.range(1), hll_type_from_arg(state.range(0)), 1 << 20);
+  for (auto _: state) {
+    benchmark::DoNotOptimize(sketch.get_estimate());
+  }
+}
+BENCHMARK(BM_hll_get_estimate)->ArgsProduct({{4, 6, 8}, {12, 16, 21}});
+
+// args: type, lg_k
+static void BM_hll_serialize_compact(benchmark::State& state) {
+  const auto sketch = make_hll_sketch(state.range(1), hll_type_from_arg(state.range(0)), 1 << 20);
+  for (auto _: state) {
+    auto bytes = sketch.serialize_compact();
+    benchmark::DoNotOptimize(bytes.data());
+  }
+}
+BENCHMARK(BM_hll_serialize_compact)->ArgsProduct({{4, 6, 8}, {12, 16, 21}});
+
+// args: type, lg_k
+static void BM_hll_deserialize(benchmark::State& state) {
+  const auto bytes = make_hll_sketch(state.range(1), hll_type_from_arg(state.range(0)), 1 << 20).serialize_compact();
+  for (auto _: state) {
+    auto sketch = hll_sketch::deserialize(bytes.data(), bytes.size());
+    benchmark::DoNotOptimize(sketch.get_lg_config_k());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * bytes.size());
+}
+BENCHMARK(BM_hll_deserialize)->ArgsProduct({{4, 6, 8}, {12, 16, 21}});
+
+} /* namespace datasketches */
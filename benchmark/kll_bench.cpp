@@ -0,0 +1,207 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <kll_sketch.hpp>
+
+#include "bench_util.hpp"
+
+namespace datasketches {
+
+// args: k, stream length
+static void BM_kll_update(benchmark::State& state) {
+  const uint16_t k = state.range(0);
+  const auto values = make_uniform_values<float>(state.range(1));
+  for (auto _: state) {
+    kll_sketch<float> sketch(k);
+    for (float value: values) sketch.update(value);
+    benchmark::DoNotOptimize(sketch.get_n());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_kll_update)->ArgsProduct({{100, 200, 800}, BENCH_STREAM_LENGTHS});
+
+// args: k, stream length
+// the stream arrives in batches of 4096 values
+static void BM_kll_update_batch(benchmark::State& state) {
+  const uint16_t k = state.range(0);
+  const auto values = make_uniform_values<float>(state.range(1));
+  const size_t batch_size = 4096;
+  for (auto _: state) {
+    kll_sketch<float> sketch(k);
+    for (size_t i = 0; i < values.size(); i += batch_size) {
+      sketch.update(values.data() + i, std::min(batch_size, values.size() - i));
+    }
+    benchmark::DoNotOptimize(sketch.get_n());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_kll_update_batch)->ArgsProduct({{100, 200, 800}, BENCH_STREAM_LENGTHS});
+
+static std::vector<kll_sketch<float>> make_kll_sketches(uint16_t k, size_t num_sketches, size_t n) {
+  std::vector<kll_sketch<float>> sketches;
+  for (size_t i = 0; i < num_sketches; ++i) {
+    kll_sketch<float> sketch(k);
+    for (float value: make_uniform_values<float>(n, BENCH_SEED + i)) sketch.update(value);
+    sketches.push_back(std::move(sketch));
+  }
+  return sketches;
+}
+
+// args: k, number of sketches to merge
+static void BM_kll_merge(benchmark::State& state) {
+  const uint16_t k = state.range(0);
+  const auto sketches = make_kll_sketches(k, state.range(1), 1 << 14);
+  for (auto _: state) {
+    kll_sketch<float> sketch(k);
+    for (const auto& other: sketches) sketch.merge(other);
+    benchmark::DoNotOptimize(sketch.get_n());
+  }
+  set_items_processed(state, sketches.size());
+}
+BENCHMARK(BM_kll_merge)->ArgsProduct({{100, 200, 800}, {16, 256}});
+
+static std::vector<std::vector<uint8_t>> serialize_all(const std::vector<kll_sketch<float>>& sketches) {
+  std::vector<std::vector<uint8_t>> blobs;
+  for (const auto& sketch: sketches) blobs.push_back(sketch.serialize());
+  return blobs;
+}
+
+// args: k, number of sketches to merge
+static void BM_kll_deserialize_and_merge(benchmark::State& state) {
+  const uint16_t k = state.range(0);
+  const auto blobs = serialize_all(make_kll_sketches(k, state.range(1), 1 << 14));
+  for (auto _: state) {
+    kll_sketch<float> sketch(k);
+    for (const auto& blob: blobs) sketch.merge(kll_sketch<float>::deserialize(blob.data(), blob.size()));
+    benchmark::DoNotOptimize(sketch.get_n());
+  }
+  set_items_processed(state, blobs.size());
+}
+BENCHMARK(BM_kll_deserialize_and_merge)->ArgsProduct({{100, 200, 800}, {16, 256}});
+
+// args: k, number of sketches to merge
+static void BM_kll_merge_serialized(benchmark::State& state) {
+  const uint16_t k = state.range(0);
+  const auto blobs = serialize_all(make_kll_sketches(k, state.range(1), 1 << 14));
+  for (auto _: state) {
+    kll_sketch<float> sketch(k);
+    for (const auto& blob: blobs) sketch.merge_serialized(blob.data(), blob.size());
+    benchmark::DoNotOptimize(sketch.get_n());
+  }
+  set_items_processed(state, blobs.size());
+}
+BENCHMARK(BM_kll_merge_serialized)->ArgsProduct({{100, 200, 800}, {16, 256}});
+
+// args: k, number of sketches to merge, number of threads
+static void BM_kll_merge_all(benchmark::State& state) {
+  const uint16_t k = state.range(0);
+  const auto sketches = make_kll_sketches(k, state.range(1), 1 << 14);
+  for (auto _: state) {
+    auto sketch = kll_sketch<float>::merge_all(sketches.begin(), sketches.end(), state.range(2));
+    benchmark::DoNotOptimize(sketch.get_n());
+  }
+  set_items_processed(state, sketches.size());
+}
+BENCHMARK(BM_kll_merge_all)->ArgsProduct({{100, 200, 800}, {16, 256}, {1, 4}})->UseRealTime();
+
+// args: k, stream length
+static void BM_kll_get_quantile(benchmark::State& state) {
+  const auto sketch = make_kll_sketches(state.range(0), 1, state.range(1))[0];
+  double rank = 0;
+  for (auto _: state) {
+    benchmark::DoNotOptimize(sketch.get_quantile(rank));
+    rank = rank < 0.99 ? rank + 0.01 : 0;
+  }
+  set_items_processed(state, 1);
+}
+BENCHMARK(BM_kll_get_quantile)->ArgsProduct({{100, 200, 800}, BENCH_STREAM_LENGTHS});
+
+// args: k, stream length
+static void BM_kll_get_rank(benchmark::State& state) {
+  const auto sketch = make_kll_sketches(state.range(0), 1, state.range(1))[0];
+  float value = 0;
+  for (auto _: state) {
+    benchmark::DoNotOptimize(sketch.get_rank(value));
+    value = value < 0.99f ? value + 0.01f : 0;
+  }
+  set_items_processed(state, 1);
+}
+BENCHMARK(BM_kll_get_rank)->ArgsProduct({{100, 200, 800}, BENCH_STREAM_LENGTHS});
+
+// args: k, stream length
+static void BM_kll_get_ranks(benchmark::State& state) {
+  const auto sketch = make_kll_sketches(state.range(0), 1, state.range(1))[0];
+  const auto values = make_uniform_values<float>(1 << 16, BENCH_SEED + 1);
+  for (auto _: state) {
+    benchmark::DoNotOptimize(sketch.get_ranks(values.data(), values.size()).data());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_kll_get_ranks)->ArgsProduct({{100, 200, 800}, BENCH_STREAM_LENGTHS});
+
+// args: k, stream length
+// the view is built once, so this measures the query alone
+static void BM_kll_sorted_view_get_quantile(benchmark::State& state) {
+  const auto sketch = make_kll_sketches(state.range(0), 1, state.range(1))[0];
+  const auto view = sketch.get_sorted_view();
+  double rank = 0.01;
+  for (auto _: state) {
+    benchmark::DoNotOptimize(view.get_quantile(rank));
+    rank = rank < 0.99 ? rank + 0.01 : 0.01;
+  }
+  set_items_processed(state, 1);
+}
+BENCHMARK(BM_kll_sorted_view_get_quantile)->ArgsProduct({{100, 200, 800}, BENCH_STREAM_LENGTHS});
+
+// args: k, stream length
+static void BM_kll_sorted_view_get_rank(benchmark::State& state) {
+  const auto sketch = make_kll_sketches(state.range(0), 1, state.range(1))[0];
+  const auto view = sketch.get_sorted_view();
+  float value = 0;
+  for (auto _: state) {
+    benchmark::DoNotOptimize(view.get_rank(value));
+    value = value < 0.99f ? value + 0.01f : 0;
+  }
+  set_items_processed(state, 1);
+}
+BENCHMARK(BM_kll_sorted_view_get_rank)->ArgsProduct({{100, 200, 800}, BENCH_STREAM_LENGTHS});
+
+// args: k, stream length
+static void BM_kll_serialize(benchmark::State& state) {
+  const auto sketch = make_kll_sketches(state.range(0), 1, state.range(1))[0];
+  for (auto _: state) {
+    auto bytes = sketch.serialize();
+    benchmark::DoNotOptimize(bytes.data());
+  }
+}
+BENCHMARK(BM_kll_serialize)->ArgsProduct({{100, 200, 800}, BENCH_STREAM_LENGTHS});
+
+// args: k, stream length
+static void BM_kll_deserialize(benchmark::State& state) {
+  const auto bytes = make_kll_sketches(state.range(0), 1, state.range(1))[0].serialize();
+  for (auto _: state) {
+    auto sketch = kll_sketch<float>::deserialize(bytes.data(), bytes.size());
+    benchmark::DoNotOptimize(sketch.get_n());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * bytes.size());
+}
+BENCHMARK(BM_kll_deserialize)->ArgsProduct({{100, 200, 800}, BENCH_STREAM_LENGTHS});
+
+} /* namespace datasketches */
@@ -0,0 +1,116 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <req_sketch.hpp>
+
+#include "bench_util.hpp"
+
+namespace datasketches {
+
+static req_sketch<float> make_req_sketch(uint16_t k, size_t n, uint64_t seed = BENCH_SEED) {
+  req_sketch<float> sketch(k);
+  for (float value: make_uniform_values<float>(n, seed)) sketch.update(value);
+  return sketch;
+}
+
+// args: k, stream length
+static void BM_req_update(benchmark::State& state) {
+  const uint16_t k = state.range(0);
+  const auto values = make_uniform_values<float>(state.range(1));
+  for (auto _: state) {
+    req_sketch<float> sketch(k);
+    for (float value: values) sketch.update(value);
+    benchmark::DoNotOptimize(sketch.get_n());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_req_update)->ArgsProduct({{12, 24, 48}, BENCH_STREAM_LENGTHS});
+
+// args: k, number of sketches to merge
+static void BM_req_merge(benchmark::State& state) {
+  const uint16_t k = state.range(0);
+  std::vector<req_sketch<float>> sketches;
+  for (int64_t i = 0; i < state.range(1); ++i) sketches.push_back(make_req_sketch(k, 1 << 14, BENCH_SEED + i));
+  for (auto _: state) {
+    req_sketch<float> sketch(k);
+    for (const auto& other: sketches) sketch.merge(other);
+    benchmark::DoNotOptimize(sketch.get_n());
+  }
+  set_items_processed(state, sketches.size());
+}
+BENCHMARK(BM_req_merge)->ArgsProduct({{12, 24, 48}, {16, 256}});
+
+// args: k, stream length
+static void BM_req_get_quantile(benchmark::State& state) {
+  const auto sketch = make_req_sketch(state.range(0), state.range(1));
+  double rank = 0;
+  for (auto _: state) {
+    benchmark::DoNotOptimize(sketch.get_quantile(rank));
+    rank = rank < 0.99 ? rank + 0.01 : 0;
+  }
+  set_items_processed(state, 1);
+}
+BENCHMARK(BM_req_get_quantile)->ArgsProduct({{12, 24, 48}, BENCH_STREAM_LENGTHS});
+
+// args: k, stream length
+static void BM_req_get_rank(benchmark::State& state) {
+  const auto sketch = make_req_sketch(state.range(0), state.range(1));
+  float value = 0;
+  for (auto _: state) {
+    benchmark::DoNotOptimize(sketch.get_rank(value));
+    value = value < 0.99f ? value + 0.01f : 0;
+  }
+  set_items_processed(state, 1);
+}
+BENCHMARK(BM_req_get_rank)->ArgsProduct({{12, 24, 48}, BENCH_STREAM_LENGTHS});
+
+// args: k, stream length
+static void BM_req_get_ranks(benchmark::State& state) {
+  const auto sketch = make_req_sketch(state.range(0), state.range(1));
+  const auto values = make_uniform_values<float>(1 << 16, BENCH_SEED + 1);
+  for (auto _: state) {
+    benchmark::DoNotOptimize(sketch.get_ranks(values.data(), values.size()).data());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_req_get_ranks)->ArgsProduct({{12, 24, 48}, BENCH_STREAM_LENGTHS});
+
+// args: k, stream length
+static void BM_req_serialize(benchmark::State& state) {
+  const auto sketch = make_req_sketch(state.range(0), state.range(1));
+  for (auto _: state) {
+    auto bytes = sketch.serialize();
+    benchmark::DoNotOptimize(bytes.data());
+  }
+}
+BENCHMARK(BM_req_serialize)->ArgsProduct({{12, 24, 48}, BENCH_STREAM_LENGTHS});
+
+// args: k, stream length
+static void BM_req_deserialize(benchmark::State& state) {
+  const auto bytes = make_req_sketch(state.range(0), state.range(1)).serialize();
+  for (auto _: state) {
+    auto sketch = req_sketch<float>::deserialize(bytes.data(), bytes.size());
+    benchmark::DoNotOptimize(sketch.get_n());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * bytes.size());
+}
+BENCHMARK(BM_req_deserialize)->ArgsProduct({{12, 24, 48}, BENCH_STREAM_LENGTHS});
+
+} /* namespace datasketches */
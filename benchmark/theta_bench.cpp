@@ -0,0 +1,157 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <theta_sketch.hpp>
+#include <theta_union.hpp>
+#include <theta_parallel_union.hpp>
+#include <theta_intersection.hpp>
+
+#include "bench_util.hpp"
+
+namespace datasketches {
+
+static compact_theta_sketch make_compact_theta_sketch(uint8_t lg_k, size_t n, uint64_t seed = BENCH_SEED) {
+  update_theta_sketch sketch = update_theta_sketch::builder().set_lg_k(lg_k).build();
+  for (uint64_t value: make_distinct_values(n, seed)) sketch.update(value);
+  return sketch.compact();
+}
+
+// args: lg_k, stream length
+static void BM_theta_update(benchmark::State& state) {
+  const uint8_t lg_k = state.range(0);
+  const auto values = make_distinct_values(state.range(1));
+  for (auto _: state) {
+    update_theta_sketch sketch = update_theta_sketch::builder().set_lg_k(lg_k).build();
+    for (uint64_t value: values) sketch.update(value);
+    benchmark::DoNotOptimize(sketch.get_num_retained());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_theta_update)->ArgsProduct({{10, 12, 16}, BENCH_STREAM_LENGTHS});
+
+// args: lg_k, stream length
+static void BM_theta_update_batch(benchmark::State& state) {
+  const uint8_t lg_k = state.range(0);
+  const auto values = make_distinct_values(state.range(1));
+  for (auto _: state) {
+    update_theta_sketch sketch = update_theta_sketch::builder().set_lg_k(lg_k).build();
+    sketch.update_batch(values.data(), values.size());
+    benchmark::DoNotOptimize(sketch.get_num_retained());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_theta_update_batch)->ArgsProduct({{10, 12, 16}, BENCH_STREAM_LENGTHS});
+
+// args: lg_k, stream length
+static void BM_theta_update_string(benchmark::State& state) {
+  const uint8_t lg_k = state.range(0);
+  const auto values = to_strings(make_distinct_values(state.range(1)));
+  for (auto _: state) {
+    update_theta_sketch sketch = update_theta_sketch::builder().set_lg_k(lg_k).build();
+    for (const auto& value: values) sketch.update(value);
+    benchmark::DoNotOptimize(sketch.get_num_retained());
+  }
+  set_items_processed(state, values.size());
+}
+BENCHMARK(BM_theta_update_string)->ArgsProduct({{10, 12, 16}, BENCH_STREAM_LENGTHS});
+
+// args: lg_k, number of sketches
+static void BM_theta_union(benchmark::State& state) {
+  const uint8_t lg_k = state.range(0);
+  std::vector<compact_theta_sketch> sketches;
+  for (int64_t i = 0; i < state.range(1); ++i) sketches.push_back(make_compact_theta_sketch(lg_k, 1 << 16, BENCH_SEED + i));
+  for (auto _: state) {
+    theta_union u = theta_union::builder().set_lg_k(lg_k).build();
+    for (const auto& sketch: sketches) u.update(sketch);
+    benchmark::DoNotOptimize(u.get_result().get_num_retained());
+  }
+  set_items_processed(state, sketches.size());
+}
+BENCHMARK(BM_theta_union)->ArgsProduct({{10, 12, 16}, {16, 256}});
+
+// args: lg_k, number of sketches, number of threads
+static void BM_theta_parallel_union(benchmark::State& state) {
+  const uint8_t lg_k = state.range(0);
+  std::vector<compact_theta_sketch> sketches;
+  for (int64_t i = 0; i < state.range(1); ++i) sketches.push_back(make_compact_theta_sketch(lg_k, 1 << 16, BENCH_SEED + i));
+  const auto builder = theta_union::builder().set_lg_k(lg_k);
+  for (auto _: state) {
+    auto result = parallel_union(sketches.begin(), sketches.end(), state.range(2), builder);
+    benchmark::DoNotOptimize(result.get_num_retained());
+  }
+  set_items_processed(state, sketches.size());
+}
+BENCHMARK(BM_theta_parallel_union)->ArgsProduct({{12, 16}, {1024}, {1, 2, 4}})->UseRealTime();
+
+// args: lg_k, number of sketches
+static void BM_theta_intersection(benchmark::State& state) {
+  const uint8_t lg_k = state.range(0);
+  // the same seed makes all inputs identical, so that the intersection stays non-trivial
+  std::vector<compact_theta_sketch> sketches;
+  for (int64_t i = 0; i < state.range(1); ++i) sketches.push_back(make_compact_theta_sketch(lg_k, 1 << 16));
+  for (auto _: state) {
+    theta_intersection intersection;
+    for (const auto& sketch: sketches) intersection.update(sketch);
+    benchmark::DoNotOptimize(intersection.get_result().get_num_retained());
+  }
+  set_items_processed(state, sketches.size());
+}
+BENCHMARK(BM_theta_intersection)->ArgsProduct({{10, 12, 16}, {16, 256}});
+
+// args: lg_k
+static void BM_theta_serialize(benchmark::State& state) {
+  const auto sketch = make_compact_theta_sketch(state.range(0), 1 << 20);
+  for (auto _: state) {
+    auto bytes = sketch.serialize();
+    benchmark::DoNotOptimize(bytes.data());
+  }
+}
+BENCHMARK(BM_theta_serialize)->DenseRange(10, 16, 2);
+
+// args: lg_k
+static void BM_theta_deserialize(benchmark::State& state) {
+  const auto bytes = make_compact_theta_sketch(state.range(0), 1 << 20).serialize();
+  for (auto _: state) {
+    auto sketch = compact_theta_sketch::deserialize(bytes.data(), bytes.size());
+    benchmark::DoNotOptimize(sketch.get_num_retained());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * bytes.size());
+}
+BENCHMARK(BM_theta_deserialize)->DenseRange(10, 16, 2);
+
+// args: lg_k, number of sketches, wrap (0 deserializes)
+static void BM_theta_union_serialized(benchmark::State& state) {
+  const uint8_t lg_k = state.range(0);
+  std::vector<compact_theta_sketch::vector_bytes> serialized;
+  for (int64_t i = 0; i < state.range(1); ++i) serialized.push_back(make_compact_theta_sketch(lg_k, 1 << 16, BENCH_SEED + i).serialize());
+  const bool wrap = state.range(2) != 0;
+  for (auto _: state) {
+    theta_union u = theta_union::builder().set_lg_k(lg_k).build();
+    for (const auto& bytes: serialized) {
+      if (wrap) u.update(wrapped_compact_theta_sketch::wrap(bytes.data(), bytes.size()));
+      else u.update(compact_theta_sketch::deserialize(bytes.data(), bytes.size()));
+    }
+    benchmark::DoNotOptimize(u.get_result().get_num_retained());
+  }
+  set_items_processed(state, serialized.size());
+}
+BENCHMARK(BM_theta_union_serialized)->ArgsProduct({{10, 12, 16}, {256}, {0, 1}});
+
+} /* namespace datasketches */
@@ -0,0 +1,84 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <var_opt_sketch.hpp>
+#include <var_opt_union.hpp>
+
+#include "bench_util.hpp"
+
+namespace datasketches {
+
+static var_opt_sketch<uint64_t> make_var_opt_sketch(uint32_t k, size_t n, uint64_t seed = BENCH_SEED) {
+  var_opt_sketch<uint64_t> sketch(k);
+  const auto weights = make_uniform_values<double>(n, seed);
+  for (size_t i = 0; i < n; ++i) sketch.update(i, weights[i] * 100 + 1);
+  return sketch;
+}
+
+// args: k, stream length
+static void BM_var_opt_update(benchmark::State& state) {
+  const uint32_t k = state.range(0);
+  const size_t n = state.range(1);
+  const auto weights = make_uniform_values<double>(n);
+  for (auto _: state) {
+    var_opt_sketch<uint64_t> sketch(k);
+    for (size_t i = 0; i < n; ++i) sketch.update(i, weights[i] * 100 + 1);
+    benchmark::DoNotOptimize(sketch.get_n());
+  }
+  set_items_processed(state, n);
+}
+BENCHMARK(BM_var_opt_update)->ArgsProduct({{32, 256, 4096}, BENCH_STREAM_LENGTHS});
+
+// args: k, number of sketches
+static void BM_var_opt_union(benchmark::State& state) {
+  const uint32_t k = state.range(0);
+  std::vector<var_opt_sketch<uint64_t>> sketches;
+  for (int64_t i = 0; i < state.range(1); ++i) sketches.push_back(make_var_opt_sketch(k, 1 << 14, BENCH_SEED + i));
+  for (auto _: state) {
+    var_opt_union<uint64_t> u(k);
+    for (const auto& sketch: sketches) u.update(sketch);
+    benchmark::DoNotOptimize(u.get_result().get_n());
+  }
+  set_items_processed(state, sketches.size());
+}
+BENCHMARK(BM_var_opt_union)->ArgsProduct({{32, 256, 4096}, {16, 64}});
+
+// args: k
+static void BM_var_opt_serialize(benchmark::State& state) {
+  const auto sketch = make_var_opt_sketch(state.range(0), 1 << 16);
+  for (auto _: state) {
+    auto bytes = sketch.serialize();
+    benchmark::DoNotOptimize(bytes.data());
+  }
+}
+BENCHMARK(BM_var_opt_serialize)->Arg(32)->Arg(256)->Arg(4096);
+
+// args: k
+static void BM_var_opt_deserialize(benchmark::State& state) {
+  const auto bytes = make_var_opt_sketch(state.range(0), 1 << 16).serialize();
+  for (auto _: state) {
+    auto sketch = var_opt_sketch<uint64_t>::deserialize(bytes.data(), bytes.size());
+    benchmark::DoNotOptimize(sketch.get_n());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * bytes.size());
+}
+BENCHMARK(BM_var_opt_deserialize)->Arg(32)->Arg(256)->Arg(4096);
+
+} /* namespace datasketches */
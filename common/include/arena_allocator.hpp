@@ -0,0 +1,198 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef ARENA_ALLOCATOR_HPP_
+#define ARENA_ALLOCATOR_HPP_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "common_defs.hpp"
+#include "MurmurHash3.h"
+#include "serde.hpp"
+
+namespace datasketches {
+
+/**
+ * Memory arena for many small blocks, such as the contents of string items of a sketch.
+ *
+ * Small blocks are carved out of large chunks with a bump pointer. Their sizes are rounded up
+ * to a power of 2, and freed blocks go to a free list for their size, from which later
+ * allocations of the same size are served. So the memory freed when a sketch purges or compacts
+ * its items is reused for new items instead of fragmenting the heap, and the memory
+ * held by the arena is bounded by the peak size of the items alive at the same time.
+ * Blocks larger than MAX_BLOCK_SIZE, such as arrays of items, are passed to the global operator new.
+ * Chunks are returned to the system when the arena is destroyed.
+ *
+ * Not thread safe: an arena, and everything allocated from it, must be used by one thread at a time.
+ * The arena must outlive everything allocated from it.
+ */
+class memory_arena {
+public:
+  static const size_t MIN_BLOCK_SIZE = 16;
+  static const size_t MAX_BLOCK_SIZE = 4096;
+  static const size_t DEFAULT_CHUNK_SIZE = 1 << 16;
+
+  /**
+   * Constructor
+   * @param chunk_size size of the chunks obtained from the system, at least MAX_BLOCK_SIZE
+   */
+  explicit memory_arena(size_t chunk_size = DEFAULT_CHUNK_SIZE):
+  chunk_size_(chunk_size < MAX_BLOCK_SIZE ? MAX_BLOCK_SIZE : chunk_size),
+  chunks_(),
+  next_(nullptr),
+  end_(nullptr),
+  free_lists_(),
+  allocated_bytes_(0)
+  {}
+
+  ~memory_arena() {
+    for (char* chunk: chunks_) ::operator delete(chunk);
+  }
+
+  memory_arena(const memory_arena&) = delete;
+  memory_arena& operator=(const memory_arena&) = delete;
+
+  void* allocate(size_t size) {
+    if (size > MAX_BLOCK_SIZE) return ::operator new(size);
+    const unsigned size_class = get_size_class(size);
+    const size_t block_size = MIN_BLOCK_SIZE << size_class;
+    allocated_bytes_ += block_size;
+    if (free_lists_[size_class] != nullptr) {
+      free_block* block = free_lists_[size_class];
+      free_lists_[size_class] = block->next;
+      return block;
+    }
+    if (static_cast<size_t>(end_ - next_) < block_size) {
+      next_ = static_cast<char*>(::operator new(chunk_size_));
+      end_ = next_ + chunk_size_;
+      chunks_.push_back(next_);
+    }
+    void* block = next_;
+    next_ += block_size;
+    return block;
+  }
+
+  void deallocate(void* ptr, size_t size) {
+    if (size > MAX_BLOCK_SIZE) {
+      ::operator delete(ptr);
+      return;
+    }
+    const unsigned size_class = get_size_class(size);
+    allocated_bytes_ -= MIN_BLOCK_SIZE << size_class;
+    free_lists_[size_class] = new (ptr) free_block{free_lists_[size_class]};
+  }
+
+  /**
+   * @return bytes in small blocks that are currently allocated, with sizes rounded up
+   */
+  size_t get_allocated_bytes() const { return allocated_bytes_; }
+
+  /**
+   * @return bytes in chunks obtained from the system
+   */
+  size_t get_reserved_bytes() const { return chunks_.size() * chunk_size_; }
+
+private:
+  struct free_block { free_block* next; };
+  static const unsigned NUM_SIZE_CLASSES = 9; // 16 to 4096 bytes
+
+  size_t chunk_size_;
+  std::vector<char*> chunks_;
+  char* next_;
+  char* end_;
+  free_block* free_lists_[NUM_SIZE_CLASSES];
+  size_t allocated_bytes_;
+
+  static unsigned get_size_class(size_t size) {
+    unsigned size_class = 0;
+    while ((MIN_BLOCK_SIZE << size_class) < size) ++size_class;
+    return size_class;
+  }
+};
+
+/**
+ * Allocator that takes memory from a given memory_arena.
+ * A default-constructed allocator has no arena and uses the global operator new.
+ * Containers propagate the allocator on copy, move and swap, so items keep allocating
+ * from the arena of the sketch they were created for.
+ */
+template<typename T>
+class arena_allocator {
+public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  template<typename U>
+  struct rebind { using other = arena_allocator<U>; };
+
+  arena_allocator() noexcept: arena_(nullptr) {}
+  explicit arena_allocator(memory_arena& arena) noexcept: arena_(&arena) {}
+  template<typename U>
+  arena_allocator(const arena_allocator<U>& other) noexcept: arena_(other.get_arena()) {}
+
+  T* allocate(size_t n) {
+    const size_t size = n * sizeof(T);
+    return static_cast<T*>(arena_ != nullptr ? arena_->allocate(size) : ::operator new(size));
+  }
+
+  void deallocate(T* ptr, size_t n) {
+    if (arena_ != nullptr) arena_->deallocate(ptr, n * sizeof(T));
+    else ::operator delete(ptr);
+  }
+
+  memory_arena* get_arena() const { return arena_; }
+
+private:
+  memory_arena* arena_;
+};
+
+template<typename T, typename U>
+bool operator==(const arena_allocator<T>& a, const arena_allocator<U>& b) {
+  return a.get_arena() == b.get_arena();
+}
+
+template<typename T, typename U>
+bool operator!=(const arena_allocator<T>& a, const arena_allocator<U>& b) {
+  return a.get_arena() != b.get_arena();
+}
+
+/**
+ * String item with contents in a memory_arena.
+ * To keep the items of a sketch in its arena, create them with the allocator given to the sketch,
+ * and pass serde<arena_string>(allocator) to deserialize().
+ * std::equal_to and std::less work as with std::string. std::hash does not, so arena_string_hash is provided.
+ */
+using arena_string = string<arena_allocator<char>>;
+
+struct arena_string_hash {
+  size_t operator()(const arena_string& item) const {
+    HashState hashes;
+    MurmurHash3_x64_128(item.data(), static_cast<int>(item.size()), DEFAULT_SEED, hashes);
+    return static_cast<size_t>(hashes.h1);
+  }
+};
+
+} /* namespace datasketches */
+
+#endif
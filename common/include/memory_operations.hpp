@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <exception>
+#include <cstring>
 #include <iostream>
 
 namespace datasketches {
@@ -64,6 +65,16 @@ static inline size_t copy_from_mem(const void* src, T& item) {
   return sizeof(T);
 }
 
+// hint that the cache line containing a given address is about to be written
+// no-op if the compiler does not provide a suitable intrinsic
+static inline void prefetch_for_write(const void* ptr) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(ptr, 1);
+#else
+  (void) ptr;
+#endif
+}
+
 } // namespace
 
 #endif // _MEMORY_OPERATIONS_HPP_
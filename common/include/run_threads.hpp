@@ -0,0 +1,61 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#ifndef RUN_THREADS_HPP_
+#define RUN_THREADS_HPP_
+
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace datasketches {
+
+// runs fn(thread_index) for thread_index in [0, num_threads) on separate threads,
+// waits for all of them and rethrows the first exception thrown by any of them.
+// If a thread cannot be created, the threads already started are joined
+// and the exception is rethrown. Thread can be replaced for testing.
+template<typename Thread = std::thread, typename F>
+void run_threads(unsigned num_threads, F fn) {
+  std::vector<std::exception_ptr> errors(num_threads);
+  std::vector<Thread> threads;
+  threads.reserve(num_threads);
+  try {
+    for (unsigned t = 0; t < num_threads; ++t) {
+      threads.emplace_back([&fn, &errors, t]() {
+        try {
+          fn(t);
+        } catch (...) {
+          errors[t] = std::current_exception();
+        }
+      });
+    }
+  } catch (...) {
+    for (auto& thread: threads) thread.join();
+    throw;
+  }
+  for (auto& thread: threads) thread.join();
+  for (auto& error: errors) {
+    if (error) std::rethrow_exception(error);
+  }
+}
+
+} /* namespace datasketches */
+
+#endif // RUN_THREADS_HPP_
@@ -92,9 +92,14 @@ struct serde<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
 // ItemsSketch<String> with ArrayOfStringsSerDe in Java.
 // The length of each string is stored as a 32-bit integer (historically),
 // which may be too wasteful. Treat this as an example.
-template<>
-struct serde<std::string> {
-  void serialize(std::ostream& os, const std::string* items, unsigned num) const {
+// Strings with a custom allocator are supported as well. Deserialized strings
+// are constructed with the allocator given to the constructor.
+template<typename A>
+struct serde<std::basic_string<char, std::char_traits<char>, A>> {
+  using string_type = std::basic_string<char, std::char_traits<char>, A>;
+  explicit serde(const A& allocator = A()): allocator_(allocator) {}
+
+  void serialize(std::ostream& os, const string_type* items, unsigned num) const {
     unsigned i = 0;
     bool failure = false;
     try {
@@ -110,7 +115,7 @@ struct serde<std::string> {
       throw std::runtime_error("error writing to std::ostream at item " + std::to_string(i));
     }
   }
-  void deserialize(std::istream& is, std::string* items, unsigned num) const {
+  void deserialize(std::istream& is, string_type* items, unsigned num) const {
     unsigned i = 0;
     bool failure = false;
     try {
@@ -118,13 +123,13 @@ struct serde<std::string> {
         uint32_t length;
         is.read((char*)&length, sizeof(length));
         if (!is.good()) { break; }
-        std::string str;
+        string_type str(allocator_);
         str.reserve(length);
         for (uint32_t j = 0; j < length; j++) {
           str.push_back(is.get());
         }
         if (!is.good()) { break; }
-        new (&items[i]) std::string(std::move(str));
+        new (&items[i]) string_type(std::move(str));
       }
     } catch (std::istream::failure& e) {
       failure = true;
@@ -137,10 +142,10 @@ struct serde<std::string> {
       throw std::runtime_error("error reading from std::istream at item " + std::to_string(i)); 
     }
   }
-  size_t size_of_item(const std::string& item) const {
+  size_t size_of_item(const string_type& item) const {
     return sizeof(uint32_t) + item.size();
   }
-  size_t serialize(void* ptr, size_t capacity, const std::string* items, unsigned num) const {
+  size_t serialize(void* ptr, size_t capacity, const string_type* items, unsigned num) const {
     size_t bytes_written = 0;
     for (unsigned i = 0; i < num; ++i) {
       const uint32_t length = items[i].size();
@@ -154,7 +159,7 @@ struct serde<std::string> {
     }
     return bytes_written;
   }
-  size_t deserialize(const void* ptr, size_t capacity, std::string* items, unsigned num) const {
+  size_t deserialize(const void* ptr, size_t capacity, string_type* items, unsigned num) const {
     size_t bytes_read = 0;
     unsigned i = 0;
     bool failure = false;
@@ -174,7 +179,7 @@ struct serde<std::string> {
         failure = true;
         break;
       }
-      new (&items[i]) std::string(static_cast<const char*>(ptr), length);
+      new (&items[i]) string_type(static_cast<const char*>(ptr), length, allocator_);
       ptr = static_cast<const char*>(ptr) + length;
       bytes_read += length;
     }
@@ -189,6 +194,9 @@ struct serde<std::string> {
 
     return bytes_read;
   }
+
+private:
+  A allocator_;
 };
 
 } /* namespace datasketches */
@@ -0,0 +1,121 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#ifndef XOSHIRO256_HPP_
+#define XOSHIRO256_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <utility>
+
+namespace datasketches {
+
+/*
+ * xoshiro256** pseudo-random generator by David Blackman and Sebastiano Vigna.
+ * Satisfies UniformRandomBitGenerator, so it can be used with the standard distributions.
+ * The state is 32 bytes, which is cheap enough for each sketch to own one.
+ * Unless seeded explicitly, an instance takes its seed from a per-thread sequence,
+ * which is initialized from the clock and the thread id.
+ * A copy of an unseeded instance takes a new seed from that sequence, so that copies of
+ * one prototype are independent. A copy of a seeded instance continues the same sequence.
+ * Moves keep the state.
+ */
+class xoshiro256 {
+public:
+  using result_type = uint64_t;
+
+  xoshiro256(): seeded_(false) { expand(next_seed()); }
+  explicit xoshiro256(uint64_t seed) { this->seed(seed); }
+
+  xoshiro256(const xoshiro256& other): seeded_(other.seeded_) {
+    if (seeded_) std::copy(other.s_, other.s_ + 4, s_);
+    else expand(next_seed());
+  }
+
+  xoshiro256(xoshiro256&& other) = default;
+
+  xoshiro256& operator=(const xoshiro256& other) {
+    xoshiro256 copy(other);
+    *this = std::move(copy);
+    return *this;
+  }
+
+  xoshiro256& operator=(xoshiro256&& other) = default;
+
+  void seed(uint64_t seed) {
+    expand(seed);
+    seeded_ = true;
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  result_type operator()() {
+    const uint64_t result = rotl(s_[1] * 5, 7) * 9;
+    const uint64_t t = s_[1] << 17;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = rotl(s_[3], 45);
+    return result;
+  }
+
+  // uniform in [0, 1) using the upper 53 bits
+  double next_double() {
+    return static_cast<double>((*this)() >> 11) * (1.0 / static_cast<double>(1ULL << 53));
+  }
+
+private:
+  uint64_t s_[4];
+  bool seeded_;
+
+  // the state is expanded from the seed with splitmix64, as recommended by the authors
+  void expand(uint64_t seed) {
+    for (auto& word: s_) word = splitmix64(seed);
+  }
+
+  static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  static inline uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  static uint64_t next_seed() {
+    static thread_local uint64_t seed_state =
+        static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count())
+        ^ (static_cast<uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) << 1);
+    return splitmix64(seed_state);
+  }
+};
+
+} /* namespace datasketches */
+
+#endif // XOSHIRO256_HPP_
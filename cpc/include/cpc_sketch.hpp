@@ -194,6 +194,24 @@ public:
    */
   void update(const void* value, int size);
 
+  /**
+   * Update this sketch with each of the given unsigned 64-bit integers.
+   * The result is the same as calling update() for each of them, but the items are hashed in blocks,
+   * those that cannot change the sketch are dropped early, and the window bytes or table slots
+   * of the rest are prefetched, which helps sketches that do not fit in the cache.
+   * @param values array of integers
+   * @param size number of integers
+   */
+  void update_batch(const uint64_t* values, size_t size);
+
+  /**
+   * Update this sketch with each of the given strings.
+   * The result is the same as calling update() for each of them, so empty strings are skipped.
+   * @param values array of strings
+   * @param size number of strings
+   */
+  void update_batch(const std::string* values, size_t size);
+
   /**
    * Returns a human-readable summary of this sketch
    */
@@ -248,6 +266,9 @@ private:
 
   enum flags { IS_BIG_ENDIAN, IS_COMPRESSED, HAS_HIP, HAS_TABLE, HAS_WINDOW };
 
+  static const size_t UPDATE_BATCH_SIZE = 64;
+  static const size_t MAX_UNSTAGED_BYTES = 1 << 14;
+
   // Note: except for brief transitional moments, these sketches always obey
   // the following strict mapping between the flavor of a sketch and the
   // number of coupons that it has collected
@@ -277,6 +298,8 @@ private:
       vector_u8<A>&& window, bool has_hip, double kxp, double hip_est_accum, uint64_t seed);
 
   inline void row_col_update(uint32_t row_col);
+  void row_col_update(uint32_t* row_cols, size_t size);
+  inline bool is_batch_staged() const;
   inline void update_sparse(uint32_t row_col);
   inline void update_windowed(uint32_t row_col);
   inline void update_hip(uint32_t row_col);
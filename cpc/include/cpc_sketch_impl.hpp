@@ -32,6 +32,7 @@
 #include "icon_estimator.hpp"
 #include "serde.hpp"
 #include "count_zeros.hpp"
+#include "memory_operations.hpp"
 
 namespace datasketches {
 
@@ -194,6 +195,79 @@ void cpc_sketch_alloc<A>::update(const void* value, int size) {
   row_col_update(row_col_from_two_hashes(hashes.h1, hashes.h2, lg_k));
 }
 
+template<typename A>
+void cpc_sketch_alloc<A>::update_batch(const uint64_t* values, size_t size) {
+  uint32_t row_cols[UPDATE_BATCH_SIZE];
+  while (size > 0) {
+    const size_t block_size = size < UPDATE_BATCH_SIZE ? size : UPDATE_BATCH_SIZE;
+    const bool staged = is_batch_staged();
+    for (size_t i = 0; i < block_size; ++i) {
+      HashState hashes;
+      MurmurHash3_x64_128(&values[i], sizeof(uint64_t), seed, hashes);
+      const uint32_t row_col = row_col_from_two_hashes(hashes.h1, hashes.h2, lg_k);
+      if (staged) row_cols[i] = row_col;
+      else row_col_update(row_col);
+    }
+    if (staged) row_col_update(row_cols, block_size);
+    values += block_size;
+    size -= block_size;
+  }
+}
+
+template<typename A>
+void cpc_sketch_alloc<A>::update_batch(const std::string* values, size_t size) {
+  uint32_t row_cols[UPDATE_BATCH_SIZE];
+  while (size > 0) {
+    const size_t block_size = size < UPDATE_BATCH_SIZE ? size : UPDATE_BATCH_SIZE;
+    const bool staged = is_batch_staged();
+    size_t num_row_cols = 0;
+    for (size_t i = 0; i < block_size; ++i) {
+      if (values[i].empty()) continue;
+      HashState hashes;
+      MurmurHash3_x64_128(values[i].c_str(), values[i].length(), seed, hashes);
+      const uint32_t row_col = row_col_from_two_hashes(hashes.h1, hashes.h2, lg_k);
+      if (staged) row_cols[num_row_cols++] = row_col;
+      else row_col_update(row_col);
+    }
+    if (staged) row_col_update(row_cols, num_row_cols);
+    values += block_size;
+    size -= block_size;
+  }
+}
+
+// Staging a block of row_cols pays off once first_interesting_column lets it drop items early
+// or once the window or the table no longer fit in the L1 cache.
+// Before that, a block is applied as it is hashed.
+template<typename A>
+bool cpc_sketch_alloc<A>::is_batch_staged() const {
+  return first_interesting_column > 0 || sliding_window.size() > MAX_UNSTAGED_BYTES
+      || (sizeof(uint32_t) << surprising_value_table.get_lg_size()) > MAX_UNSTAGED_BYTES;
+}
+
+// Once the sketch is large, most columns are below first_interesting_column,
+// so those are dropped without branching before anything is looked up.
+// The memory touched by the rest is requested first, then they are applied one by one,
+// since any of them may move the window or resize the table.
+template<typename A>
+void cpc_sketch_alloc<A>::row_col_update(uint32_t* row_cols, size_t size) {
+  size_t num_row_cols = 0;
+  for (size_t i = 0; i < size; ++i) {
+    row_cols[num_row_cols] = row_cols[i];
+    num_row_cols += (row_cols[i] & 63) >= first_interesting_column;
+  }
+  // in sparse mode there is no window yet, and every item goes to the table
+  const bool is_sparse = sliding_window.size() == 0;
+  for (size_t i = 0; i < num_row_cols; ++i) {
+    const uint8_t col = row_cols[i] & 63;
+    if (!is_sparse && col >= window_offset && col < window_offset + 8) {
+      prefetch_for_write(&sliding_window[row_cols[i] >> 6]);
+    } else {
+      surprising_value_table.prefetch(row_cols[i]);
+    }
+  }
+  for (size_t i = 0; i < num_row_cols; ++i) row_col_update(row_cols[i]);
+}
+
 template<typename A>
 void cpc_sketch_alloc<A>::row_col_update(uint32_t row_col) {
   const uint8_t col = row_col & 63;
@@ -51,6 +51,8 @@ public:
   inline bool maybe_insert(uint32_t item);
   // returns true iff the item was present and was therefore removed from the table
   inline bool maybe_delete(uint32_t item);
+  // hints that the slot where a lookup of the item starts is about to be accessed
+  inline void prefetch(uint32_t item) const;
 
   static u32_table make_from_pairs(const uint32_t* pairs, size_t num_pairs, uint8_t lg_k, const A& allocator);
 
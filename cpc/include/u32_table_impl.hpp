@@ -26,6 +26,8 @@
 #include <algorithm>
 #include <climits>
 
+#include "memory_operations.hpp"
+
 namespace datasketches {
 
 template<typename A>
@@ -108,6 +110,11 @@ bool u32_table<A>::maybe_delete(uint32_t item) {
   return true;
 }
 
+template<typename A>
+void u32_table<A>::prefetch(uint32_t item) const {
+  prefetch_for_write(slots.data() + (item >> (num_valid_bits - lg_size)));
+}
+
 // this one is specifically tailored to be a part of fm85 decompression scheme
 template<typename A>
 u32_table<A> u32_table<A>::make_from_pairs(const uint32_t* pairs, size_t num_pairs, uint8_t lg_k, const A& allocator) {
@@ -21,6 +21,8 @@
 #include <cstring>
 #include <sstream>
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include <catch.hpp>
 
@@ -378,4 +380,48 @@ TEST_CASE("cpc sketch: update string equivalence", "[cpc_sketch]") {
   REQUIRE(sketch.get_estimate() == Approx(1).margin(RELATIVE_ERROR_FOR_LG_K_11));
 }
 
+TEST_CASE("cpc sketch: update batch", "[cpc_sketch]") {
+  // sizes cover all flavors from sparse to sliding, and a size that is not a multiple of the batch
+  std::vector<uint64_t> values;
+  std::vector<std::string> strings;
+  for (uint64_t i = 0; i < 100001; ++i) {
+    values.push_back(i * 0x9E3779B97F4A7C15ULL);
+    strings.push_back(i % 97 == 0 ? std::string() : std::to_string(i));
+  }
+  for (uint8_t lg_k: {4, 10, 14}) {
+    for (size_t n: {5, 100, 1001, 100001}) {
+      cpc_sketch sk1(lg_k);
+      cpc_sketch sk2(lg_k);
+      for (size_t i = 0; i < n; ++i) sk1.update(values[i]);
+      sk2.update_batch(values.data(), n);
+      REQUIRE(sk2.validate());
+      REQUIRE(sk1.get_estimate() == sk2.get_estimate());
+      REQUIRE(sk1.serialize() == sk2.serialize());
+
+      cpc_sketch sk3(lg_k);
+      cpc_sketch sk4(lg_k);
+      for (size_t i = 0; i < n; ++i) sk3.update(strings[i]);
+      sk4.update_batch(strings.data(), n);
+      REQUIRE(sk3.get_estimate() == sk4.get_estimate());
+      REQUIRE(sk3.serialize() == sk4.serialize());
+    }
+  }
+}
+
+TEST_CASE("cpc sketch: update batch large sparse", "[cpc_sketch]") {
+  // the table outgrows the L1 cache long before 3k/32 coupons, so batches are staged while still sparse
+  std::vector<uint64_t> values;
+  for (uint64_t i = 0; i < 65536; ++i) values.push_back(i * 0x9E3779B97F4A7C15ULL);
+  for (uint8_t lg_k: {17, 20}) {
+    const size_t n = lg_k == 17 ? 10000 : values.size(); // fewer than 3k/32 coupons
+    cpc_sketch sk1(lg_k);
+    cpc_sketch sk2(lg_k);
+    for (size_t i = 0; i < n; ++i) sk1.update(values[i]);
+    sk2.update_batch(values.data(), n);
+    REQUIRE(sk2.validate());
+    REQUIRE(sk1.get_estimate() == sk2.get_estimate());
+    REQUIRE(sk1.serialize() == sk2.serialize());
+  }
+}
+
 } /* namespace datasketches */
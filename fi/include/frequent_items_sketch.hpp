@@ -82,6 +82,17 @@ public:
    */
   void update(T&& item, W weight = 1);
 
+  /**
+   * Update this sketch with an array of items and their weights.
+   * The result is the same as updating with each item in turn.
+   * @param items array of items
+   * @param weights array of weights, one per item, or nullptr to give each item weight 1
+   * @param size number of items
+   * Weights of zero are skipped. If any weight is negative, an exception is thrown
+   * before the sketch is changed.
+   */
+  void update(const T* items, const W* weights, size_t size);
+
   /**
    * This function merges the other sketch into this one.
    * The other sketch may be of a different size.
@@ -257,6 +268,14 @@ public:
    */
   static frequent_items_sketch deserialize(std::istream& is, const A& allocator = A());
 
+  /**
+   * This method deserializes a sketch from a given stream using a given instance of serde.
+   * @param is input stream
+   * @param sd instance of serde to deserialize items with, for instance with a given allocator
+   * @return an instance of the sketch
+   */
+  static frequent_items_sketch deserialize(std::istream& is, const S& sd, const A& allocator = A());
+
   /**
    * This method deserializes a sketch from a given array of bytes.
    * @param bytes pointer to the array of bytes
@@ -265,6 +284,15 @@ public:
    */
   static frequent_items_sketch deserialize(const void* bytes, size_t size, const A& allocator = A());
 
+  /**
+   * This method deserializes a sketch from a given array of bytes using a given instance of serde.
+   * @param bytes pointer to the array of bytes
+   * @param size the size of the array
+   * @param sd instance of serde to deserialize items with, for instance with a given allocator
+   * @return an instance of the sketch
+   */
+  static frequent_items_sketch deserialize(const void* bytes, size_t size, const S& sd, const A& allocator = A());
+
   /**
    * Returns a human readable summary of this sketch
    * @param print_items if true include the list of items retained by the sketch
@@ -300,6 +328,9 @@ private:
 
   // for deserialize
   class items_deleter;
+
+  template<typename TT, typename WW, typename HH, typename EE, typename SS, typename AA>
+  friend class sharded_frequent_items_sketch;
 };
 
 template<typename T, typename W, typename H, typename E, typename S, typename A>
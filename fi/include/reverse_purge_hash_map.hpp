@@ -38,6 +38,7 @@ class reverse_purge_hash_map {
 public:
   using AllocV = typename std::allocator_traits<A>::template rebind_alloc<V>;
   using AllocU16 = typename std::allocator_traits<A>::template rebind_alloc<uint16_t>;
+  using AllocU32 = typename std::allocator_traits<A>::template rebind_alloc<uint32_t>;
 
   reverse_purge_hash_map(uint8_t lg_size, uint8_t lg_max_size, const A& allocator);
   reverse_purge_hash_map(const reverse_purge_hash_map& other);
@@ -72,11 +73,12 @@ private:
   K* keys_;
   V* values_;
   uint16_t* states_;
+  uint32_t* hashes_; // low 32 bits of the hash of each active key, compared before the keys
 
+  static inline uint32_t hash_key(const K& key);
   inline bool is_active(uint32_t probe) const;
   void subtract_and_keep_positive_only(V amount);
-  void hash_delete(uint32_t probe);
-  uint32_t internal_adjust_or_insert(const K& key, V value);
+  uint32_t internal_adjust_or_insert(const K& key, uint32_t hash, V value);
   V resize_or_purge_if_needed();
   void resize(uint8_t lg_new_size);
   V purge();
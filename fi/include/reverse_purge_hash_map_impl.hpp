@@ -24,6 +24,7 @@
 #include <algorithm>
 #include <iterator>
 #include <cmath>
+#include <type_traits>
 
 #include "MurmurHash3.h"
 
@@ -41,13 +42,17 @@ lg_max_size_(lg_max_size),
 num_active_(0),
 keys_(allocator_.allocate(1 << lg_cur_size)),
 values_(nullptr),
-states_(nullptr)
+states_(nullptr),
+hashes_(nullptr)
 {
   AllocV av(allocator_);
   values_ = av.allocate(1 << lg_cur_size);
+  std::fill(values_, values_ + (1 << lg_cur_size), 0); // purge() reads the values of empty slots too
   AllocU16 au16(allocator_);
   states_ = au16.allocate(1 << lg_cur_size);
   std::fill(states_, states_ + (1 << lg_cur_size), 0);
+  AllocU32 au32(allocator_);
+  hashes_ = au32.allocate(1 << lg_cur_size);
 }
 
 template<typename K, typename V, typename H, typename E, typename A>
@@ -58,23 +63,27 @@ lg_max_size_(other.lg_max_size_),
 num_active_(other.num_active_),
 keys_(allocator_.allocate(1 << lg_cur_size_)),
 values_(nullptr),
-states_(nullptr)
+states_(nullptr),
+hashes_(nullptr)
 {
   AllocV av(allocator_);
   values_ = av.allocate(1 << lg_cur_size_);
   AllocU16 au16(allocator_);
   states_ = au16.allocate(1 << lg_cur_size_);
+  AllocU32 au32(allocator_);
+  hashes_ = au32.allocate(1 << lg_cur_size_);
   const uint32_t size = 1 << lg_cur_size_;
   if (num_active_ > 0) {
     auto num = num_active_;
     for (uint32_t i = 0; i < size; i++) {
       if (other.states_[i] > 0) {
         new (&keys_[i]) K(other.keys_[i]);
-        values_[i] = other.values_[i];
+        hashes_[i] = other.hashes_[i];
+        if (--num == 0) break;
       }
-      if (--num == 0) break;
     }
   }
+  std::copy(other.values_, other.values_ + size, values_);
   std::copy(other.states_, other.states_ + size, states_);
 }
 
@@ -86,11 +95,13 @@ lg_max_size_(other.lg_max_size_),
 num_active_(other.num_active_),
 keys_(nullptr),
 values_(nullptr),
-states_(nullptr)
+states_(nullptr),
+hashes_(nullptr)
 {
   std::swap(keys_, other.keys_);
   std::swap(values_, other.values_);
   std::swap(states_, other.states_);
+  std::swap(hashes_, other.hashes_);
   other.num_active_ = 0;
 }
 
@@ -116,6 +127,10 @@ reverse_purge_hash_map<K, V, H, E, A>::~reverse_purge_hash_map() {
     AllocU16 au16(allocator_);
     au16.deallocate(states_, size);
   }
+  if (hashes_ != nullptr) {
+    AllocU32 au32(allocator_);
+    au32.deallocate(hashes_, size);
+  }
 }
 
 template<typename K, typename V, typename H, typename E, typename A>
@@ -127,6 +142,7 @@ reverse_purge_hash_map<K, V, H, E, A>& reverse_purge_hash_map<K, V, H, E, A>::op
   std::swap(keys_, other.keys_);
   std::swap(values_, other.values_);
   std::swap(states_, other.states_);
+  std::swap(hashes_, other.hashes_);
   return *this;
 }
 
@@ -139,6 +155,7 @@ reverse_purge_hash_map<K, V, H, E, A>& reverse_purge_hash_map<K, V, H, E, A>::op
   std::swap(keys_, other.keys_);
   std::swap(values_, other.values_);
   std::swap(states_, other.states_);
+  std::swap(hashes_, other.hashes_);
   return *this;
 }
 
@@ -146,7 +163,7 @@ template<typename K, typename V, typename H, typename E, typename A>
 template<typename FwdK>
 V reverse_purge_hash_map<K, V, H, E, A>::adjust_or_insert(FwdK&& key, V value) {
   const uint32_t num_active_before = num_active_;
-  const uint32_t index = internal_adjust_or_insert(key, value);
+  const uint32_t index = internal_adjust_or_insert(key, hash_key(key), value);
   if (num_active_ > num_active_before) {
     new (&keys_[index]) K(std::forward<FwdK>(key));
     return resize_or_purge_if_needed();
@@ -157,9 +174,10 @@ V reverse_purge_hash_map<K, V, H, E, A>::adjust_or_insert(FwdK&& key, V value) {
 template<typename K, typename V, typename H, typename E, typename A>
 V reverse_purge_hash_map<K, V, H, E, A>::get(const K& key) const {
   const uint32_t mask = (1 << lg_cur_size_) - 1;
-  uint32_t probe = fmix64(H()(key)) & mask;
+  const uint32_t hash = hash_key(key);
+  uint32_t probe = hash & mask;
   while (is_active(probe)) {
-    if (E()(keys_[probe], key)) return values_[probe];
+    if (hashes_[probe] == hash && E()(keys_[probe], key)) return values_[probe];
     probe = (probe + 1) & mask;
   }
   return 0;
@@ -203,6 +221,12 @@ typename reverse_purge_hash_map<K, V, H, E, A>::iterator reverse_purge_hash_map<
   return reverse_purge_hash_map<K, V, H, E, A>::iterator(this, 1 << lg_cur_size_, num_active_);
 }
 
+template<typename K, typename V, typename H, typename E, typename A>
+uint32_t reverse_purge_hash_map<K, V, H, E, A>::hash_key(const K& key) {
+  // the map never has more than 2^31 slots, so the low 32 bits are enough to find the slot in any size
+  return static_cast<uint32_t>(fmix64(H()(key)));
+}
+
 template<typename K, typename V, typename H, typename E, typename A>
 bool reverse_purge_hash_map<K, V, H, E, A>::is_active(uint32_t index) const {
   return states_[index] > 0;
@@ -210,71 +234,54 @@ bool reverse_purge_hash_map<K, V, H, E, A>::is_active(uint32_t index) const {
 
 template<typename K, typename V, typename H, typename E, typename A>
 void reverse_purge_hash_map<K, V, H, E, A>::subtract_and_keep_positive_only(V amount) {
-  // starting from the back, find the first empty cell,
-  // which establishes the high end of a cluster.
-  uint32_t first_probe = (1 << lg_cur_size_) - 1;
-  while (is_active(first_probe)) first_probe--;
-  // when we find the next non-empty cell, we know we are at the high end of a cluster
-  // work towards the front, delete any non-positive entries.
-  for (uint32_t probe = first_probe; probe-- > 0;) {
-    if (is_active(probe)) {
-      if (values_[probe] <= amount) {
-        hash_delete(probe); // does the work of deletion and moving higher items towards the front
-        num_active_--;
-      } else {
-        values_[probe] -= amount;
-      }
-    }
-  }
-  // now work on the first cluster that was skipped
-  for (uint32_t probe = (1 << lg_cur_size_); probe-- > first_probe;) {
-    if (is_active(probe)) {
-      if (values_[probe] <= amount) {
-        hash_delete(probe);
-        num_active_--;
-      } else {
-        values_[probe] -= amount;
-      }
-    }
+  const uint32_t size = 1 << lg_cur_size_;
+  const uint32_t mask = size - 1;
+  // no cluster wraps around a slot that was empty before the purge,
+  // so the survivors can be placed again in the order of their slots starting from there
+  uint32_t start = 0;
+  while (is_active(start)) start++;
+
+  // one branch-free pass marks non-positive entries as empty and subtracts from the rest
+  uint32_t num_active = 0;
+  for (uint32_t i = 0; i < size; i++) {
+    const bool keep = (states_[i] > 0) & (values_[i] > amount);
+    if (!std::is_trivially_destructible<K>::value && states_[i] > 0 && !keep) keys_[i].~K();
+    states_[i] = keep ? states_[i] : 0;
+    values_[i] = keep ? values_[i] - amount : 0;
+    num_active += keep;
   }
-}
+  num_active_ = num_active;
 
-template<typename K, typename V, typename H, typename E, typename A>
-void reverse_purge_hash_map<K, V, H, E, A>::hash_delete(uint32_t delete_index) {
-  // Looks ahead in the table to search for another
-  // item to move to this location
-  // if none are found, the status is changed
-  states_[delete_index] = 0; // mark as empty
-  keys_[delete_index].~K();
-  uint32_t drift = 1;
-  const uint32_t mask = (1 << lg_cur_size_) - 1;
-  uint32_t probe = (delete_index + drift) & mask; // map length must be a power of 2
-  // advance until we find a free location replacing locations as needed
-  while (is_active(probe)) {
-    if (states_[probe] > drift) {
-      // move current element
-      new (&keys_[delete_index]) K(std::move(keys_[probe]));
-      values_[delete_index] = values_[probe];
-      states_[delete_index] = states_[probe] - drift;
-      states_[probe] = 0; // mark as empty
+  // every survivor goes to the first free slot from its home slot,
+  // which is never past its current slot since the slots before it are placed already
+  for (uint32_t n = 1; n <= size; n++) {
+    const uint32_t probe = (start + n) & mask;
+    if (!is_active(probe)) continue;
+    uint32_t index = hashes_[probe] & mask;
+    uint16_t drift = 1;
+    while (index != probe && is_active(index)) {
+      index = (index + 1) & mask;
+      drift++;
+    }
+    if (index != probe) {
+      new (&keys_[index]) K(std::move(keys_[probe]));
       keys_[probe].~K();
-      drift = 0;
-      delete_index = probe;
+      values_[index] = values_[probe];
+      hashes_[index] = hashes_[probe];
+      values_[probe] = 0;
+      states_[probe] = 0;
     }
-    probe = (probe + 1) & mask;
-    drift++;
-    // only used for theoretical analysis
-    if (drift >= DRIFT_LIMIT) throw std::logic_error("drift: " + std::to_string(drift) + " >= DRIFT_LIMIT");
+    states_[index] = drift;
   }
 }
 
 template<typename K, typename V, typename H, typename E, typename A>
-uint32_t reverse_purge_hash_map<K, V, H, E, A>::internal_adjust_or_insert(const K& key, V value) {
+uint32_t reverse_purge_hash_map<K, V, H, E, A>::internal_adjust_or_insert(const K& key, uint32_t hash, V value) {
   const uint32_t mask = (1 << lg_cur_size_) - 1;
-  uint32_t index = fmix64(H()(key)) & mask;
+  uint32_t index = hash & mask;
   uint16_t drift = 1;
   while (is_active(index)) {
-    if (E()(keys_[index], key)) {
+    if (hashes_[index] == hash && E()(keys_[index], key)) {
       // adjusting the value of an existing key
       values_[index] += value;
       return index;
@@ -290,6 +297,7 @@ uint32_t reverse_purge_hash_map<K, V, H, E, A>::internal_adjust_or_insert(const
   }
   values_[index] = value;
   states_[index] = drift;
+  hashes_[index] = hash;
   num_active_++;
   return index;
 }
@@ -316,24 +324,42 @@ void reverse_purge_hash_map<K, V, H, E, A>::resize(uint8_t lg_new_size) {
   K* old_keys = keys_;
   V* old_values = values_;
   uint16_t* old_states = states_;
+  uint32_t* old_hashes = hashes_;
   const uint32_t new_size = 1 << lg_new_size;
   keys_ = allocator_.allocate(new_size);
   AllocV av(allocator_);
   values_ = av.allocate(new_size);
+  std::fill(values_, values_ + new_size, 0);
   AllocU16 au16(allocator_);
   states_ = au16.allocate(new_size);
   std::fill(states_, states_ + new_size, 0);
-  num_active_ = 0;
+  AllocU32 au32(allocator_);
+  hashes_ = au32.allocate(new_size);
   lg_cur_size_ = lg_new_size;
+  // keys are distinct and the new map has room for all of them,
+  // so each one goes to the first free slot from its stored hash without comparing keys
+  const uint32_t mask = new_size - 1;
   for (uint32_t i = 0; i < old_size; i++) {
     if (old_states[i] > 0) {
-      adjust_or_insert(std::move(old_keys[i]), old_values[i]);
+      uint32_t index = old_hashes[i] & mask;
+      uint16_t drift = 1;
+      while (is_active(index)) {
+        index = (index + 1) & mask;
+        drift++;
+        // only used for theoretical analysis
+        if (drift >= DRIFT_LIMIT) throw std::logic_error("drift limit reached");
+      }
+      new (&keys_[index]) K(std::move(old_keys[i]));
+      values_[index] = old_values[i];
+      states_[index] = drift;
+      hashes_[index] = old_hashes[i];
       old_keys[i].~K();
     }
   }
   allocator_.deallocate(old_keys, old_size);
   av.deallocate(old_values, old_size);
   au16.deallocate(old_states, old_size);
+  au32.deallocate(old_hashes, old_size);
 }
 
 template<typename K, typename V, typename H, typename E, typename A>
@@ -341,17 +367,15 @@ V reverse_purge_hash_map<K, V, H, E, A>::purge() {
   const uint32_t limit = std::min(MAX_SAMPLE_SIZE, num_active_);
   uint32_t num_samples = 0;
   uint32_t i = 0;
-  AllocV av(allocator_);
-  V* samples = av.allocate(limit);
+  V samples[MAX_SAMPLE_SIZE]; // values are arithmetic, so this is at most a few kilobytes
   while (num_samples < limit) {
     if (is_active(i)) {
       samples[num_samples++] = values_[i];
     }
     i++;
   }
-  std::nth_element(samples, samples+ (num_samples / 2), samples + num_samples);
+  std::nth_element(samples, samples + (num_samples / 2), samples + num_samples);
   const V median = samples[num_samples / 2];
-  av.deallocate(samples, limit);
   subtract_and_keep_positive_only(median);
   return median;
 }
@@ -0,0 +1,141 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef SHARDED_FREQUENT_ITEMS_SKETCH_HPP_
+#define SHARDED_FREQUENT_ITEMS_SKETCH_HPP_
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "frequent_items_sketch.hpp"
+
+namespace datasketches {
+
+/**
+ * Frequent items sketch that can be updated from many threads at the same time.
+ *
+ * Items are routed by hash to a number of shards. Each shard is a frequent items sketch
+ * with its own lock and a map 1/2^ceil(log2(num_shards)) of the configured size,
+ * so that all shards together take no more space than one sketch of the configured size.
+ * Since every item goes to exactly one shard, the shards track disjoint sets of items.
+ * This allows get_result() to combine them into one frequent_items_sketch by inserting
+ * the entries of all shards and taking the largest of their maximum errors as the
+ * maximum error of the result, instead of adding them up as merge() has to do for arbitrary sketches.
+ * The bounds reported by the result, based on get_maximum_error(), always hold.
+ * The a-priori error given by get_epsilon() of the result, which is that of a sketch of the configured size,
+ * holds only when the weight is spread evenly across the shards. In the worst case, a shard that receives
+ * more than its share of the weight can have a maximum error up to 2^ceil(log2(num_shards)) times larger.
+ */
+template<
+  typename T,
+  typename W = uint64_t,
+  typename H = std::hash<T>,
+  typename E = std::equal_to<T>,
+  typename S = serde<T>,
+  typename A = std::allocator<T>
+>
+class sharded_frequent_items_sketch {
+public:
+  using sketch_type = frequent_items_sketch<T, W, H, E, S, A>;
+
+  /**
+   * Constructor
+   * @param lg_max_map_size log2 of the size of the map of the combined sketch
+   * (see frequent_items_sketch)
+   * @param num_shards number of shards, usually about the number of writer threads
+   * @param allocator instance of an allocator
+   */
+  sharded_frequent_items_sketch(uint8_t lg_max_map_size, unsigned num_shards, const A& allocator = A());
+
+  /**
+   * Update this sketch with an item and a positive weight (frequency count).
+   * Can be called from many threads at the same time.
+   * @param item for which the weight should be increased (lvalue)
+   * @param weight the amount by which the weight of the item should be increased
+   * A count of zero is a no-op, and a negative count will throw an exception.
+   */
+  void update(const T& item, W weight = 1);
+
+  /**
+   * Update this sketch with an item and a positive weight (frequency count).
+   * Can be called from many threads at the same time.
+   * @param item for which the weight should be increased (rvalue)
+   * @param weight the amount by which the weight of the item should be increased
+   * A count of zero is a no-op, and a negative count will throw an exception.
+   */
+  void update(T&& item, W weight = 1);
+
+  /**
+   * Update this sketch with an array of items and their weights using a given number of threads.
+   * The items are partitioned by shard, and each thread then updates its own subset of the shards.
+   * Can be called while other threads update this sketch.
+   * @param items array of items
+   * @param weights array of weights, one per item, or nullptr to give each item weight 1
+   * @param size number of items
+   * @param num_threads number of threads to use, must be positive
+   * Weights of zero are skipped. If any weight is negative, an exception is thrown
+   * before the sketch is changed.
+   */
+  void update(const T* items, const W* weights, size_t size, unsigned num_threads);
+
+  /**
+   * @return number of shards
+   */
+  unsigned get_num_shards() const;
+
+  /**
+   * @return log2 of the size of the map of the combined sketch
+   */
+  uint8_t get_lg_max_map_size() const;
+
+  /**
+   * @return true if this sketch is empty
+   */
+  bool is_empty() const;
+
+  /**
+   * @return the total weight of all items seen by this sketch
+   */
+  W get_total_weight() const;
+
+  /**
+   * Combines the shards into one frequent items sketch with a map of size 2^lg_max_map_size.
+   * Each shard is locked while it is copied, so updates from other threads may proceed
+   * and end up either in the result or not.
+   * @return frequent items sketch
+   */
+  sketch_type get_result() const;
+
+private:
+  using AllocSketch = typename std::allocator_traits<A>::template rebind_alloc<sketch_type>;
+  A allocator_;
+  uint8_t lg_max_map_size_;
+  std::vector<sketch_type, AllocSketch> shards_;
+  std::unique_ptr<std::mutex[]> locks_;
+
+  static uint8_t get_lg_shard_map_size(uint8_t lg_max_map_size, unsigned num_shards);
+  inline unsigned get_shard(const T& item) const;
+};
+
+} /* namespace datasketches */
+
+#include "sharded_frequent_items_sketch_impl.hpp"
+
+#endif
@@ -0,0 +1,170 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef SHARDED_FREQUENT_ITEMS_SKETCH_IMPL_HPP_
+#define SHARDED_FREQUENT_ITEMS_SKETCH_IMPL_HPP_
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "MurmurHash3.h"
+#include "run_threads.hpp"
+
+namespace datasketches {
+
+template<typename T, typename W, typename H, typename E, typename S, typename A>
+sharded_frequent_items_sketch<T, W, H, E, S, A>::sharded_frequent_items_sketch(uint8_t lg_max_map_size,
+    unsigned num_shards, const A& allocator):
+allocator_(allocator),
+lg_max_map_size_(std::max(lg_max_map_size, sketch_type::LG_MIN_MAP_SIZE)),
+shards_(allocator),
+locks_(nullptr)
+{
+  if (num_shards == 0) throw std::invalid_argument("number of shards must be positive");
+  const uint8_t lg_shard_map_size = get_lg_shard_map_size(lg_max_map_size_, num_shards);
+  shards_.reserve(num_shards);
+  for (unsigned i = 0; i < num_shards; ++i) {
+    shards_.push_back(sketch_type(lg_shard_map_size, sketch_type::LG_MIN_MAP_SIZE, allocator));
+  }
+  locks_.reset(new std::mutex[num_shards]);
+}
+
+template<typename T, typename W, typename H, typename E, typename S, typename A>
+void sharded_frequent_items_sketch<T, W, H, E, S, A>::update(const T& item, W weight) {
+  const unsigned shard = get_shard(item);
+  std::lock_guard<std::mutex> lock(locks_[shard]);
+  shards_[shard].update(item, weight);
+}
+
+template<typename T, typename W, typename H, typename E, typename S, typename A>
+void sharded_frequent_items_sketch<T, W, H, E, S, A>::update(T&& item, W weight) {
+  const unsigned shard = get_shard(item);
+  std::lock_guard<std::mutex> lock(locks_[shard]);
+  shards_[shard].update(std::move(item), weight);
+}
+
+template<typename T, typename W, typename H, typename E, typename S, typename A>
+void sharded_frequent_items_sketch<T, W, H, E, S, A>::update(const T* items, const W* weights, size_t size,
+    unsigned num_threads) {
+  if (num_threads == 0) throw std::invalid_argument("number of threads must be positive");
+  if (weights != nullptr) {
+    for (size_t i = 0; i < size; ++i) sketch_type::check_weight(weights[i]);
+  }
+  const unsigned num_shards = get_num_shards();
+  if (num_shards == 1) {
+    std::lock_guard<std::mutex> lock(locks_[0]);
+    shards_[0].update(items, weights, size);
+    return;
+  }
+  num_threads = static_cast<unsigned>(std::min<size_t>(std::min(num_threads, num_shards), size));
+  if (num_threads == 1) {
+    for (size_t i = 0; i < size; ++i) update(items[i], weights == nullptr ? 1 : weights[i]);
+    return;
+  }
+
+  // each thread partitions a contiguous chunk of the input into lists of indices by shard
+  using AllocSize = typename std::allocator_traits<A>::template rebind_alloc<size_t>;
+  using index_list = std::vector<size_t, AllocSize>;
+  using AllocIndexList = typename std::allocator_traits<A>::template rebind_alloc<index_list>;
+  std::vector<index_list, AllocIndexList> lists(num_threads * num_shards, index_list(AllocSize(allocator_)), AllocIndexList(allocator_));
+  run_threads(num_threads, [&](unsigned t) {
+    const size_t start = size * t / num_threads;
+    const size_t end = size * (t + 1) / num_threads;
+    for (size_t i = start; i < end; ++i) {
+      if (weights != nullptr && weights[i] == 0) continue;
+      lists[t * num_shards + get_shard(items[i])].push_back(i);
+    }
+  });
+
+  // then each thread takes every num_threads-th shard and applies the lists of all chunks to it
+  run_threads(num_threads, [&](unsigned t) {
+    for (unsigned shard = t; shard < num_shards; shard += num_threads) {
+      std::lock_guard<std::mutex> lock(locks_[shard]);
+      for (unsigned chunk = 0; chunk < num_threads; ++chunk) {
+        for (size_t i: lists[chunk * num_shards + shard]) {
+          shards_[shard].update(items[i], weights == nullptr ? 1 : weights[i]);
+        }
+      }
+    }
+  });
+}
+
+template<typename T, typename W, typename H, typename E, typename S, typename A>
+unsigned sharded_frequent_items_sketch<T, W, H, E, S, A>::get_num_shards() const {
+  return static_cast<unsigned>(shards_.size());
+}
+
+template<typename T, typename W, typename H, typename E, typename S, typename A>
+uint8_t sharded_frequent_items_sketch<T, W, H, E, S, A>::get_lg_max_map_size() const {
+  return lg_max_map_size_;
+}
+
+template<typename T, typename W, typename H, typename E, typename S, typename A>
+bool sharded_frequent_items_sketch<T, W, H, E, S, A>::is_empty() const {
+  for (unsigned i = 0; i < get_num_shards(); ++i) {
+    std::lock_guard<std::mutex> lock(locks_[i]);
+    if (!shards_[i].is_empty()) return false;
+  }
+  return true;
+}
+
+template<typename T, typename W, typename H, typename E, typename S, typename A>
+W sharded_frequent_items_sketch<T, W, H, E, S, A>::get_total_weight() const {
+  W total_weight = 0;
+  for (unsigned i = 0; i < get_num_shards(); ++i) {
+    std::lock_guard<std::mutex> lock(locks_[i]);
+    total_weight += shards_[i].get_total_weight();
+  }
+  return total_weight;
+}
+
+template<typename T, typename W, typename H, typename E, typename S, typename A>
+auto sharded_frequent_items_sketch<T, W, H, E, S, A>::get_result() const -> sketch_type {
+  sketch_type result(lg_max_map_size_, sketch_type::LG_MIN_MAP_SIZE, allocator_);
+  // no item is tracked by more than one shard, so the error of each estimate comes from one shard only
+  W max_shard_offset = 0;
+  W purge_offset = 0; // in case the shards do not fit, as with very small maps
+  for (unsigned i = 0; i < get_num_shards(); ++i) {
+    std::lock_guard<std::mutex> lock(locks_[i]);
+    const sketch_type& shard = shards_[i];
+    result.total_weight += shard.total_weight;
+    max_shard_offset = std::max(max_shard_offset, shard.offset);
+    for (auto& it: shard.map) purge_offset += result.map.adjust_or_insert(it.first, it.second);
+  }
+  result.offset = max_shard_offset + purge_offset;
+  return result;
+}
+
+template<typename T, typename W, typename H, typename E, typename S, typename A>
+uint8_t sharded_frequent_items_sketch<T, W, H, E, S, A>::get_lg_shard_map_size(uint8_t lg_max_map_size, unsigned num_shards) {
+  uint8_t lg_num_shards = 0;
+  while ((1ULL << lg_num_shards) < num_shards) ++lg_num_shards;
+  if (lg_max_map_size <= lg_num_shards + sketch_type::LG_MIN_MAP_SIZE) return sketch_type::LG_MIN_MAP_SIZE;
+  return lg_max_map_size - lg_num_shards;
+}
+
+template<typename T, typename W, typename H, typename E, typename S, typename A>
+unsigned sharded_frequent_items_sketch<T, W, H, E, S, A>::get_shard(const T& item) const {
+  // the map uses the low 32 bits of the same hash to place items, so the high bits are used here
+  return static_cast<unsigned>((fmix64(H()(item)) >> 32) % shards_.size());
+}
+
+} /* namespace datasketches */
+
+#endif
@@ -21,6 +21,7 @@
 #include <sstream>
 
 #include "frequent_items_sketch.hpp"
+#include "arena_allocator.hpp"
 #include "test_type.hpp"
 #include "test_allocator.hpp"
 
@@ -83,4 +84,42 @@ TEST_CASE("frequent items: negative weight", "[frequent_items_sketch]") {
   REQUIRE_THROWS_AS(sketch.update(1, -1), std::invalid_argument);
 }
 
+TEST_CASE("frequent items: arena strings", "[frequent_items_sketch]") {
+  using frequent_arena_string_sketch = frequent_items_sketch<arena_string, uint64_t, arena_string_hash,
+      std::equal_to<arena_string>, serde<arena_string>, arena_allocator<arena_string>>;
+  memory_arena arena;
+  arena_allocator<arena_string> allocator(arena);
+  {
+    frequent_arena_string_sketch sketch(6, frequent_arena_string_sketch::LG_MIN_MAP_SIZE, allocator);
+    const int n = 100000;
+    size_t total_bytes = 0;
+    for (int i = 0; i < n; i++) {
+      // every other item is the same, the rest appear once and get purged
+      const std::string str = "item with a long name " + std::to_string(i % 2 == 0 ? 0 : i);
+      sketch.update(arena_string(str.data(), str.size(), allocator));
+      total_bytes += str.size();
+    }
+    REQUIRE(sketch.get_total_weight() == n);
+    REQUIRE(sketch.get_maximum_error() > 0);
+    auto rows = sketch.get_frequent_items(frequent_items_error_type::NO_FALSE_POSITIVES);
+    REQUIRE(rows.size() == 1);
+    REQUIRE(rows[0].get_item() == "item with a long name 0");
+    REQUIRE(rows[0].get_item().get_allocator() == allocator);
+    // memory freed by purges is reused
+    REQUIRE(arena.get_reserved_bytes() < total_bytes / 10);
+
+    auto bytes = sketch.serialize();
+    auto sketch2 = frequent_arena_string_sketch::deserialize(bytes.data(), bytes.size(), serde<arena_string>(allocator), allocator);
+    REQUIRE(sketch2.get_num_active_items() == sketch.get_num_active_items());
+    REQUIRE(sketch2.get_estimate("item with a long name 0") == sketch.get_estimate("item with a long name 0"));
+    REQUIRE(sketch2.get_frequent_items(frequent_items_error_type::NO_FALSE_POSITIVES)[0].get_item().get_allocator() == allocator);
+
+    std::stringstream s(std::ios::in | std::ios::out | std::ios::binary);
+    sketch.serialize(s);
+    auto sketch3 = frequent_arena_string_sketch::deserialize(s, serde<arena_string>(allocator), allocator);
+    REQUIRE(sketch3.get_estimate("item with a long name 0") == sketch.get_estimate("item with a long name 0"));
+  }
+  REQUIRE(arena.get_allocated_bytes() == 0);
+}
+
 } /* namespace datasketches */
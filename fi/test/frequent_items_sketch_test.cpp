@@ -18,8 +18,12 @@
  */
 
 #include <catch.hpp>
+#include <algorithm>
 #include <sstream>
 #include <fstream>
+#include <map>
+#include <string>
+#include <vector>
 
 #include "frequent_items_sketch.hpp"
 
@@ -128,6 +132,63 @@ TEST_CASE("frequent items: estimation mode", "[frequent_items_sketch]") {
   REQUIRE(12 >= items.size()); // but not more than 12 items
 }
 
+TEST_CASE("frequent items: batch update", "[frequent_items_sketch]") {
+  // skewed stream: item 0 is a third of it, and a long tail of items that appear once
+  std::vector<std::string> items;
+  std::vector<uint64_t> weights;
+  std::map<std::string, uint64_t> counts;
+  for (int i = 0; i < 10000; i++) {
+    items.push_back(std::to_string(i % 3 == 0 ? 0 : i % 2 == 0 ? i % 7 : i));
+    weights.push_back(i % 11 == 0 ? 0 : i % 5 + 1);
+    counts[items.back()] += weights.back();
+  }
+
+  // exact mode matches item-by-item updates
+  frequent_items_sketch<std::string> sketch1(14);
+  frequent_items_sketch<std::string> sketch2(14);
+  for (size_t i = 0; i < items.size(); i++) sketch1.update(items[i], weights[i]);
+  sketch2.update(items.data(), weights.data(), items.size());
+  REQUIRE(sketch2.get_total_weight() == sketch1.get_total_weight());
+  REQUIRE(sketch2.get_num_active_items() == sketch1.get_num_active_items());
+  REQUIRE(sketch2.get_maximum_error() == 0);
+  for (const auto& entry: counts) REQUIRE(sketch2.get_estimate(entry.first) == entry.second);
+
+  // unit weights
+  frequent_items_sketch<std::string> sketch3(14);
+  sketch3.update(items.data(), nullptr, items.size());
+  REQUIRE(sketch3.get_total_weight() == items.size());
+  REQUIRE(sketch3.get_estimate("0") == static_cast<uint64_t>(std::count(items.begin(), items.end(), "0")));
+
+  // estimation mode keeps the bounds
+  frequent_items_sketch<std::string> sketch4(6);
+  sketch4.update(items.data(), weights.data(), items.size());
+  REQUIRE(sketch4.get_total_weight() == sketch1.get_total_weight());
+  REQUIRE(sketch4.get_maximum_error() > 0);
+  for (const auto& entry: counts) {
+    REQUIRE(sketch4.get_lower_bound(entry.first) <= entry.second);
+    REQUIRE(sketch4.get_upper_bound(entry.first) >= entry.second);
+  }
+  auto rows = sketch4.get_frequent_items(frequent_items_error_type::NO_FALSE_POSITIVES);
+  REQUIRE(rows.size() > 0);
+  REQUIRE(rows[0].get_item() == "0");
+
+  // runs of equal items
+  frequent_items_sketch<std::string> sketch6(6);
+  const std::string run_items[] = {"a", "a", "a", "b", "a", "a"};
+  const uint64_t run_weights[] = {1, 0, 2, 1, 3, 1};
+  sketch6.update(run_items, run_weights, 6);
+  REQUIRE(sketch6.get_total_weight() == 8);
+  REQUIRE(sketch6.get_estimate("a") == 7);
+  REQUIRE(sketch6.get_estimate("b") == 1);
+
+  // a negative weight is rejected before anything is applied
+  frequent_items_sketch<std::string, int64_t> sketch5(6);
+  const std::string bad_items[] = {"a", "b", "c"};
+  const int64_t bad_weights[] = {1, 2, -1};
+  REQUIRE_THROWS_AS(sketch5.update(bad_items, bad_weights, 3), std::invalid_argument);
+  REQUIRE(sketch5.is_empty());
+}
+
 TEST_CASE("frequent items: merge exact mode", "[frequent_items_sketch]") {
   frequent_items_sketch<int> sketch1(3);
   sketch1.update(1);
@@ -18,6 +18,8 @@
  */
 
 #include <catch.hpp>
+#include <map>
+#include <string>
 
 #include <reverse_purge_hash_map.hpp>
 
@@ -44,4 +46,58 @@ TEST_CASE("reverse purge hash map: iterator", "[frequent_items_sketch]") {
   REQUIRE(sum == 11);
 }
 
+// only a few distinct hashes, so that different keys share hash fingerprints
+struct colliding_string_hash {
+  size_t operator()(const std::string& key) const { return key.size() % 3; }
+};
+
+TEST_CASE("reverse purge hash map: colliding hashes", "[frequent_items_sketch]") {
+  reverse_purge_hash_map<std::string, uint64_t, colliding_string_hash> map(3, 8, std::allocator<std::string>());
+  for (int i = 0; i < 100; i++) {
+    for (int j = 0; j <= i % 5; j++) REQUIRE(map.adjust_or_insert(std::to_string(i), 1) == 0);
+  }
+  REQUIRE(map.get_num_active() == 100);
+  REQUIRE(map.get_lg_cur_size() == 8); // resized from 3
+  for (int i = 0; i < 100; i++) REQUIRE(map.get(std::to_string(i)) == static_cast<uint64_t>(i % 5 + 1));
+  REQUIRE(map.get("100") == 0);
+
+  // the copy must hold every active key, wherever its slot is
+  reverse_purge_hash_map<std::string, uint64_t, colliding_string_hash> copy(map);
+  REQUIRE(copy.get_num_active() == 100);
+  for (int i = 0; i < 100; i++) REQUIRE(copy.get(std::to_string(i)) == static_cast<uint64_t>(i % 5 + 1));
+}
+
+TEST_CASE("reverse purge hash map: purge", "[frequent_items_sketch]") {
+  // purges have to re-place the survivors of long clusters of keys with the same hash
+  reverse_purge_hash_map<std::string, uint64_t, colliding_string_hash> map(5, 5, std::allocator<std::string>());
+  std::map<std::string, uint64_t> expected;
+  int num_purges = 0;
+  for (int i = 0; i < 2000; i++) {
+    const std::string key = std::to_string(i * 7 % 301);
+    const uint64_t value = i % 4 + 1;
+    expected[key] += value;
+    const uint64_t offset = map.adjust_or_insert(key, value);
+    if (offset > 0) {
+      num_purges++;
+      for (auto it = expected.begin(); it != expected.end();) {
+        if (it->second <= offset) {
+          it = expected.erase(it);
+        } else {
+          it->second -= offset;
+          ++it;
+        }
+      }
+    }
+    REQUIRE(map.get_num_active() == expected.size());
+  }
+  REQUIRE(num_purges > 0);
+  for (const auto& entry: expected) REQUIRE(map.get(entry.first) == entry.second);
+  size_t count = 0;
+  for (auto& it: map) {
+    REQUIRE(expected[it.first] == it.second);
+    count++;
+  }
+  REQUIRE(count == expected.size());
+}
+
 } /* namespace datasketches */
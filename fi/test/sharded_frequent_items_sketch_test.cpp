@@ -0,0 +1,136 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <catch.hpp>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sharded_frequent_items_sketch.hpp"
+
+namespace datasketches {
+
+TEST_CASE("sharded frequent items: invalid arguments", "[frequent_items_sketch]") {
+  REQUIRE_THROWS_AS((sharded_frequent_items_sketch<int>(10, 0)), std::invalid_argument);
+  sharded_frequent_items_sketch<int> sketch(10, 4);
+  const int items[] = {1, 2};
+  REQUIRE_THROWS_AS(sketch.update(items, nullptr, 2, 0), std::invalid_argument);
+}
+
+TEST_CASE("sharded frequent items: empty", "[frequent_items_sketch]") {
+  sharded_frequent_items_sketch<int> sketch(10, 4);
+  REQUIRE(sketch.get_num_shards() == 4);
+  REQUIRE(sketch.get_lg_max_map_size() == 10);
+  REQUIRE(sketch.is_empty());
+  REQUIRE(sketch.get_total_weight() == 0);
+  auto result = sketch.get_result();
+  REQUIRE(result.is_empty());
+  REQUIRE(result.get_maximum_error() == 0);
+}
+
+TEST_CASE("sharded frequent items: exact mode", "[frequent_items_sketch]") {
+  sharded_frequent_items_sketch<std::string> sketch(10, 3);
+  std::map<std::string, uint64_t> counts;
+  for (int i = 0; i < 1000; i++) {
+    const std::string item = std::to_string(i % 100);
+    sketch.update(item, i % 3 + 1);
+    counts[item] += i % 3 + 1;
+  }
+  REQUIRE_FALSE(sketch.is_empty());
+  auto result = sketch.get_result();
+  REQUIRE(result.get_num_active_items() == 100);
+  REQUIRE(result.get_maximum_error() == 0);
+  REQUIRE(result.get_total_weight() == sketch.get_total_weight());
+  REQUIRE(result.get_epsilon() == frequent_items_sketch<std::string>::get_epsilon(10));
+  for (const auto& entry: counts) REQUIRE(result.get_estimate(entry.first) == entry.second);
+}
+
+TEST_CASE("sharded frequent items: concurrent updates", "[frequent_items_sketch]") {
+  const unsigned num_threads = 4;
+  const int n = 100000;
+  sharded_frequent_items_sketch<int> sketch(8, num_threads);
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < num_threads; t++) {
+    threads.emplace_back([&sketch, t]() {
+      // item 0 is a quarter of the stream, the rest appear once
+      for (int i = 0; i < n; i++) sketch.update(i % 4 == 0 ? 0 : static_cast<int>(t) * n + i);
+    });
+  }
+  for (auto& thread: threads) thread.join();
+
+  auto result = sketch.get_result();
+  REQUIRE(result.get_total_weight() == num_threads * n);
+  REQUIRE(result.get_maximum_error() > 0);
+  REQUIRE(result.get_lower_bound(0) <= num_threads * n / 4);
+  REQUIRE(result.get_upper_bound(0) >= num_threads * n / 4);
+  auto rows = result.get_frequent_items(frequent_items_error_type::NO_FALSE_POSITIVES);
+  REQUIRE(rows.size() == 1);
+  REQUIRE(rows[0].get_item() == 0);
+}
+
+TEST_CASE("sharded frequent items: parallel batch update", "[frequent_items_sketch]") {
+  std::vector<int> items;
+  std::vector<uint64_t> weights;
+  std::map<int, uint64_t> counts;
+  for (int i = 0; i < 100000; i++) {
+    items.push_back(i % 3 == 0 ? i % 5 : i);
+    weights.push_back(i % 11 == 0 ? 0 : i % 4 + 1);
+    counts[items.back()] += weights.back();
+  }
+
+  // exact mode matches item-by-item updates
+  sharded_frequent_items_sketch<int> sketch1(18, 4);
+  sketch1.update(items.data(), weights.data(), items.size(), 3);
+  auto result1 = sketch1.get_result();
+  REQUIRE(result1.get_maximum_error() == 0);
+  for (const auto& entry: counts) REQUIRE(result1.get_estimate(entry.first) == entry.second);
+
+  // estimation mode keeps the bounds
+  sharded_frequent_items_sketch<int> sketch2(8, 4);
+  sketch2.update(items.data(), weights.data(), items.size(), 4);
+  sketch2.update(items.data(), nullptr, items.size(), 2);
+  auto result2 = sketch2.get_result();
+  REQUIRE(result2.get_total_weight() == result1.get_total_weight() + items.size());
+  REQUIRE(result2.get_maximum_error() > 0);
+  for (int item: items) counts[item]++;
+  for (const auto& entry: counts) {
+    REQUIRE(result2.get_lower_bound(entry.first) <= entry.second);
+    REQUIRE(result2.get_upper_bound(entry.first) >= entry.second);
+  }
+
+  // a negative weight is rejected before anything is applied
+  sharded_frequent_items_sketch<int, int64_t> sketch3(8, 4);
+  const int bad_items[] = {1, 2, 3};
+  const int64_t bad_weights[] = {1, 2, -1};
+  REQUIRE_THROWS_AS(sketch3.update(bad_items, bad_weights, 3, 2), std::invalid_argument);
+  REQUIRE(sketch3.is_empty());
+}
+
+TEST_CASE("sharded frequent items: tiny map", "[frequent_items_sketch]") {
+  // shards at the minimum map size do not fit in the combined map, which has to purge
+  sharded_frequent_items_sketch<int> sketch(3, 8);
+  for (int i = 0; i < 1000; i++) sketch.update(i % 2 == 0 ? 0 : i);
+  auto result = sketch.get_result();
+  REQUIRE(result.get_total_weight() == 1000);
+  REQUIRE(result.get_lower_bound(0) <= 500);
+  REQUIRE(result.get_upper_bound(0) >= 500);
+}
+
+} /* namespace datasketches */
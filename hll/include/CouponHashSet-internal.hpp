@@ -113,10 +113,10 @@ CouponHashSet<A>* CouponHashSet<A>::newSet(const void* bytes, size_t len, const
   } else {
     sketch->coupons.resize(1 << lgArrInts);
     sketch->couponCount = couponCount;
-    // only need to read valid coupons, unlike in stream case
+    // valid coupons are scattered across the whole hash table
     std::memcpy(sketch->coupons.data(),
                 data + HllUtil<A>::HASH_SET_INT_ARR_START,
-                couponCount * sizeof(int));
+                couponsInArray * sizeof(int));
   }
 
   return sketch;
@@ -21,6 +21,7 @@
 #define _HLL4ARRAY_INTERNAL_HPP_
 
 #include "Hll4Array.hpp"
+#include "memory_operations.hpp"
 
 #include <cstring>
 #include <memory>
@@ -126,6 +127,17 @@ HllSketchImpl<A>* Hll4Array<A>::couponUpdate(const int coupon) {
   return this;
 }
 
+// two registers per byte, coupons not above curMin never touch them
+template<typename A>
+void Hll4Array<A>::batchCouponUpdate(const int* coupons, int numCoupons) {
+  const int configKmask = (1 << this->lgConfigK) - 1;
+  for (int i = 0; i < numCoupons; i++) {
+    if (HllUtil<A>::getValue(coupons[i]) <= this->curMin) continue; // rejected without a look at registers
+    prefetch_for_write(&this->hllByteArr[(HllUtil<A>::getLow26(coupons[i]) & configKmask) >> 1]);
+  }
+  for (int i = 0; i < numCoupons; i++) internalCouponUpdate(coupons[i]);
+}
+
 template<typename A>
 void Hll4Array<A>::internalCouponUpdate(const int coupon) {
   const int newValue = HllUtil<A>::getValue(coupon);
@@ -47,6 +47,7 @@ class Hll4Array final : public HllArray<A> {
     virtual int getHllByteArrBytes() const;
 
     virtual HllSketchImpl<A>* couponUpdate(int coupon) final;
+    virtual void batchCouponUpdate(const int* coupons, int numCoupons) final;
     void mergeHll(const HllArray<A>& src);
 
     virtual AuxHashMap<A>* getAuxHashMap() const;
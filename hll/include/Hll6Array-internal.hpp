@@ -23,6 +23,7 @@
 #include <cstring>
 
 #include "Hll6Array.hpp"
+#include "memory_operations.hpp"
 
 namespace datasketches {
 
@@ -85,6 +86,17 @@ HllSketchImpl<A>* Hll6Array<A>::couponUpdate(const int coupon) {
   return this;
 }
 
+// a register starts in byte slotNo * 6 / 8 and may spill over into the next one
+template<typename A>
+void Hll6Array<A>::batchCouponUpdate(const int* coupons, int numCoupons) {
+  const int configKmask = (1 << this->lgConfigK) - 1;
+  for (int i = 0; i < numCoupons; i++) {
+    const int slotNo = HllUtil<A>::getLow26(coupons[i]) & configKmask;
+    prefetch_for_write(&this->hllByteArr[(slotNo * 6) >> 3]);
+  }
+  for (int i = 0; i < numCoupons; i++) internalCouponUpdate(coupons[i]);
+}
+
 template<typename A>
 void Hll6Array<A>::internalCouponUpdate(const int coupon) {
   const int configKmask = (1 << this->lgConfigK) - 1;
@@ -41,6 +41,7 @@ class Hll6Array final : public HllArray<A> {
     inline void putSlot(int slotNo, uint8_t value);
 
     virtual HllSketchImpl<A>* couponUpdate(int coupon) final;
+    virtual void batchCouponUpdate(const int* coupons, int numCoupons) final;
     void mergeHll(const HllArray<A>& src);
 
     virtual int getHllByteArrBytes() const;
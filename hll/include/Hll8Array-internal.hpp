@@ -21,6 +21,10 @@
 #define _HLL8ARRAY_INTERNAL_HPP_
 
 #include "Hll8Array.hpp"
+#include "HllRegisterOps.hpp"
+#include "memory_operations.hpp"
+
+#include <algorithm>
 
 namespace datasketches {
 
@@ -71,6 +75,15 @@ HllSketchImpl<A>* Hll8Array<A>::couponUpdate(int coupon) {
   return this;
 }
 
+template<typename A>
+void Hll8Array<A>::batchCouponUpdate(const int* coupons, int numCoupons) {
+  const int configKmask = (1 << this->lgConfigK) - 1;
+  for (int i = 0; i < numCoupons; i++) {
+    prefetch_for_write(&this->hllByteArr[HllUtil<A>::getLow26(coupons[i]) & configKmask]);
+  }
+  for (int i = 0; i < numCoupons; i++) internalCouponUpdate(coupons[i]);
+}
+
 template<typename A>
 void Hll8Array<A>::internalCouponUpdate(int coupon) {
   const int configKmask = (1 << this->lgConfigK) - 1;
@@ -97,51 +110,53 @@ void Hll8Array<A>::mergeList(const CouponList<A>& src) {
 template<typename A>
 void Hll8Array<A>::mergeHll(const HllArray<A>& src) {
   // at this point src_k >= dst_k
-  const int src_k = 1 << src.getLgConfigK();
-  const  int dst_mask = (1 << this->getLgConfigK()) - 1;
-  // duplication below is to avoid a virtual method call in a loop
-  if (src.getTgtHllType() == target_hll_type::HLL_8) {
-    for (int i = 0; i < src_k; i++) {
-      const uint8_t new_v = static_cast<const Hll8Array<A>&>(src).getSlot(i);
-      const int j = i & dst_mask;
-      const uint8_t old_v = this->hllByteArr[j];
-      if (new_v > old_v) {
-        this->hllByteArr[j] = new_v;
-        this->hipAndKxQIncrementalUpdate(old_v, new_v);
-        if (old_v == 0) {
-          this->numAtCurMin--;
-        }
-      }
+  // only registers are merged, the caller must rebuild or flag the estimator state
+  mergeHllBytes(src.getHllByteArr(), src.getLgConfigK(), src.getTgtHllType(), src.getCurMin(), 0, 1 << this->lgConfigK);
+  const AuxHashMap<A>* auxHashMap = src.getAuxHashMap();
+  if (auxHashMap != nullptr) {
+    for (auto coupon: *auxHashMap) {
+      mergeCoupon(coupon);
     }
-  } else if (src.getTgtHllType() == target_hll_type::HLL_6) {
-    for (int i = 0; i < src_k; i++) {
-      const uint8_t new_v = static_cast<const Hll6Array<A>&>(src).getSlot(i);
-      const int j = i & dst_mask;
-      const uint8_t old_v = this->hllByteArr[j];
-      if (new_v > old_v) {
-        this->hllByteArr[j] = new_v;
-        this->hipAndKxQIncrementalUpdate(old_v, new_v);
-        if (old_v == 0) {
-          this->numAtCurMin--;
-        }
-      }
+  }
+}
+
+template<typename A>
+void Hll8Array<A>::mergeHllBytes(const uint8_t* srcArr, int srcLgK, target_hll_type srcType, int srcCurMin,
+    int start, int end) {
+  // at this point src_k >= dst_k
+  const int src_k = 1 << srcLgK;
+  const int dst_k = 1 << this->getLgConfigK();
+  uint8_t* dst = this->hllByteArr.data();
+  // src slots beyond dst_k fold onto the beginning of the dst array
+  for (int fold = 0; fold < src_k; fold += dst_k) {
+    if (srcType == target_hll_type::HLL_8) {
+      hll_max_merge(dst + start, srcArr + fold + start, end - start);
+      continue;
     }
-  } else { // HLL_4
-    for (int i = 0; i < src_k; i++) {
-      const uint8_t new_v = static_cast<const Hll4Array<A>&>(src).get_value(i);
-      const int j = i & dst_mask;
-      const uint8_t old_v = this->hllByteArr[j];
-      if (new_v > old_v) {
-        this->hllByteArr[j] = new_v;
-        this->hipAndKxQIncrementalUpdate(old_v, new_v);
-        if (old_v == 0) {
-          this->numAtCurMin--;
-        }
+    // HLL_4 and HLL_6 registers are unpacked to bytes block by block.
+    // HLL_4 exceptions unpack to AUX_TOKEN + curMin, which is below their true values,
+    // so merging the exceptions afterwards with mergeCoupon() gives the correct maximum.
+    const int max_block_size = 256;
+    uint8_t block[max_block_size];
+    const int block_size = std::min(dst_k, max_block_size);
+    for (int i = start; i < end; i += block_size) {
+      if (srcType == target_hll_type::HLL_6) {
+        hll_unpack6(srcArr, fold + i, block_size, block);
+      } else {
+        hll_unpack4(srcArr, fold + i, block_size, static_cast<uint8_t>(srcCurMin), block);
       }
+      hll_max_merge(dst + i, block, block_size);
     }
   }
 }
 
+template<typename A>
+void Hll8Array<A>::mergeCoupon(int coupon) {
+  const int slotNo = HllUtil<A>::getLow26(coupon) & ((1 << this->lgConfigK) - 1);
+  const uint8_t value = static_cast<uint8_t>(HllUtil<A>::getValue(coupon));
+  if (value > this->hllByteArr[slotNo]) this->hllByteArr[slotNo] = value;
+}
+
 }
 
 #endif // _HLL8ARRAY_INTERNAL_HPP_
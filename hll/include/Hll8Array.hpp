@@ -41,8 +41,14 @@ class Hll8Array final : public HllArray<A> {
     inline void putSlot(int slotNo, uint8_t value);
 
     virtual HllSketchImpl<A>* couponUpdate(int coupon) final;
+    virtual void batchCouponUpdate(const int* coupons, int numCoupons) final;
     void mergeList(const CouponList<A>& src);
     void mergeHll(const HllArray<A>& src);
+    // merges registers as stored in the byte array of an HLL sketch, exceptions of HLL_4 excluded,
+    // into the slots from start to end (exclusive), which must be aligned to min(k, 256)
+    void mergeHllBytes(const uint8_t* srcArr, int srcLgK, target_hll_type srcType, int srcCurMin, int start, int end);
+    // merges a single register given as a coupon, does not update the estimator state
+    inline void mergeCoupon(int coupon);
 
     virtual int getHllByteArrBytes() const;
 
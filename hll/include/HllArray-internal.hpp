@@ -27,6 +27,8 @@
 #include "CompositeInterpolationXTable.hpp"
 #include "CouponList.hpp"
 #include "inv_pow2_table.hpp"
+#include "HllRegisterOps.hpp"
+#include <algorithm>
 #include <cstring>
 #include <cmath>
 #include <stdexcept>
@@ -43,7 +45,8 @@ kxq1(0.0),
 hllByteArr(allocator),
 curMin(0),
 numAtCurMin(1 << lgConfigK),
-oooFlag(false)
+oooFlag(false),
+rebuildKxqCurMinFlag(false)
 {}
 
 template<typename A>
@@ -324,12 +327,15 @@ template<typename A>
 double HllArray<A>::getLowerBound(const int numStdDev) const {
   HllUtil<A>::checkNumStdDev(numStdDev);
   const int configK = 1 << this->lgConfigK;
+  double kxq0, kxq1;
+  int numAtCurMin;
+  getKxqCurMin(kxq0, kxq1, numAtCurMin);
   const double numNonZeros = ((curMin == 0) ? (configK - numAtCurMin) : configK);
 
   double estimate;
   double rseFactor;
   if (oooFlag) {
-    estimate = getCompositeEstimate();
+    estimate = getCompositeEstimate(kxq0 + kxq1, numAtCurMin);
     rseFactor = HllUtil<A>::HLL_NON_HIP_RSE_FACTOR;
   } else {
     estimate = hipAccum;
@@ -378,7 +384,15 @@ double HllArray<A>::getUpperBound(const int numStdDev) const {
 // Original C: again-two-registers.c hhb_get_composite_estimate L1489
 template<typename A>
 double HllArray<A>::getCompositeEstimate() const {
-  const double rawEst = getHllRawEstimate(this->lgConfigK, kxq0 + kxq1);
+  double kxq0, kxq1;
+  int numAtCurMin;
+  getKxqCurMin(kxq0, kxq1, numAtCurMin);
+  return getCompositeEstimate(kxq0 + kxq1, numAtCurMin);
+}
+
+template<typename A>
+double HllArray<A>::getCompositeEstimate(const double kxqSum, const int numAtCurMin) const {
+  const double rawEst = getHllRawEstimate(this->lgConfigK, kxqSum);
 
   const double* xArr = CompositeInterpolationXTable<A>::get_x_arr(this->lgConfigK);
   const int xArrLen = CompositeInterpolationXTable<A>::get_x_arr_length();
@@ -447,6 +461,99 @@ int HllArray<A>::getNumAtCurMin() const {
   return numAtCurMin;
 }
 
+template<typename A>
+const uint8_t* HllArray<A>::getHllByteArr() const {
+  return hllByteArr.data();
+}
+
+template<typename A>
+void HllArray<A>::getRegisters(int start, int n, uint8_t* dst) const {
+  switch (this->tgtHllType) {
+    case HLL_8:
+      std::copy(hllByteArr.begin() + start, hllByteArr.begin() + start + n, dst);
+      break;
+    case HLL_6:
+      hll_unpack6(hllByteArr.data(), start, n, dst);
+      break;
+    case HLL_4: {
+      hll_unpack4(hllByteArr.data(), start, n, static_cast<uint8_t>(curMin), dst);
+      const AuxHashMap<A>* auxHashMap = getAuxHashMap();
+      if (auxHashMap != nullptr) {
+        // stored values below AUX_TOKEN unpack to less than AUX_TOKEN + curMin
+        for (int i = 0; i < n; i++) {
+          if (dst[i] == HllUtil<A>::AUX_TOKEN + curMin) {
+            dst[i] = auxHashMap->mustFindValueFor(start + i);
+          }
+        }
+      }
+      break;
+    }
+  }
+}
+
+template<typename A>
+bool HllArray<A>::isRebuildKxqCurMinFlag() const {
+  return rebuildKxqCurMinFlag;
+}
+
+template<typename A>
+void HllArray<A>::putRebuildKxqCurMinFlag(bool rebuild) {
+  rebuildKxqCurMinFlag = rebuild;
+}
+
+// Recomputes kxq0, kxq1 and numAtCurMin from a histogram of the registers.
+// All terms are multiples of 2^-63 within the precision of a double,
+// so the sums are exact and equal to those maintained incrementally.
+template<typename A>
+void HllArray<A>::rebuildKxqCurMin() {
+  computeKxqCurMin(kxq0, kxq1, numAtCurMin);
+  rebuildKxqCurMinFlag = false;
+}
+
+template<typename A>
+void HllArray<A>::rebuildKxqCurMin(const uint32_t* counts) {
+  computeKxqCurMin(counts, kxq0, kxq1, numAtCurMin);
+  rebuildKxqCurMinFlag = false;
+}
+
+template<typename A>
+void HllArray<A>::getKxqCurMin(double& kxq0, double& kxq1, int& numAtCurMin) const {
+  if (rebuildKxqCurMinFlag) {
+    computeKxqCurMin(kxq0, kxq1, numAtCurMin);
+  } else {
+    kxq0 = this->kxq0;
+    kxq1 = this->kxq1;
+    numAtCurMin = this->numAtCurMin;
+  }
+}
+
+template<typename A>
+void HllArray<A>::computeKxqCurMin(double& kxq0, double& kxq1, int& numAtCurMin) const {
+  const int configK = 1 << this->lgConfigK;
+  uint32_t counts[64] = {0};
+  if (this->tgtHllType == HLL_8) {
+    hll_histogram(hllByteArr.data(), configK, counts);
+  } else {
+    const int maxBlockSize = 256;
+    uint8_t block[maxBlockSize];
+    const int blockSize = std::min(configK, maxBlockSize);
+    for (int i = 0; i < configK; i += blockSize) {
+      getRegisters(i, blockSize, block);
+      hll_histogram(block, blockSize, counts);
+    }
+  }
+  computeKxqCurMin(counts, kxq0, kxq1, numAtCurMin);
+}
+
+template<typename A>
+void HllArray<A>::computeKxqCurMin(const uint32_t* counts, double& kxq0, double& kxq1, int& numAtCurMin) const {
+  kxq0 = 0;
+  kxq1 = 0;
+  for (int v = 0; v < 32; v++) kxq0 += counts[v] * INVERSE_POWERS_OF_2[v];
+  for (int v = 32; v < 64; v++) kxq1 += counts[v] * INVERSE_POWERS_OF_2[v];
+  numAtCurMin = counts[curMin];
+}
+
 template<typename A>
 void HllArray<A>::putKxQ0(const double kxq0) {
   this->kxq0 = kxq0;
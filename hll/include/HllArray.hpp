@@ -46,6 +46,9 @@ class HllArray : public HllSketchImpl<A> {
     virtual HllArray* copyAs(target_hll_type tgtHllType) const;
 
     virtual HllSketchImpl<A>* couponUpdate(int coupon) = 0;
+    // same as couponUpdate() for each coupon, an array never changes mode.
+    // registers of a large sketch are unlikely to be in cache, so all of them are requested first
+    virtual void batchCouponUpdate(const int* coupons, int numCoupons) = 0;
 
     virtual double getEstimate() const;
     virtual double getCompositeEstimate() const;
@@ -61,6 +64,9 @@ class HllArray : public HllSketchImpl<A> {
     inline double getHipAccum() const;
 
     virtual int getHllByteArrBytes() const = 0;
+    inline const uint8_t* getHllByteArr() const;
+    // unpacks n registers starting at slot start into dst, one byte per register
+    void getRegisters(int start, int n, uint8_t* dst) const;
 
     virtual int getUpdatableSerializationBytes() const;
     virtual int getCompactSerializationBytes() const;
@@ -71,6 +77,15 @@ class HllArray : public HllSketchImpl<A> {
 
     virtual void putOutOfOrderFlag(bool flag);
 
+    // set when registers were merged without maintaining kxq0, kxq1 and numAtCurMin
+    inline bool isRebuildKxqCurMinFlag() const;
+    inline void putRebuildKxqCurMinFlag(bool rebuild);
+    void rebuildKxqCurMin();
+    // recomputes the same state from counts[0..63] of the register values, e.g. summed over stripes
+    void rebuildKxqCurMin(const uint32_t* counts);
+    // the estimator state, computed from a histogram without changing this array while the flag is set
+    void getKxqCurMin(double& kxq0, double& kxq1, int& numAtCurMin) const;
+
     inline double getKxQ0() const;
     inline double getKxQ1() const;
 
@@ -100,6 +115,9 @@ class HllArray : public HllSketchImpl<A> {
     void hipAndKxQIncrementalUpdate(uint8_t oldValue, uint8_t newValue);
     double getHllBitMapEstimate(int lgConfigK, int curMin, int numAtCurMin) const;
     double getHllRawEstimate(int lgConfigK, double kxqSum) const;
+    double getCompositeEstimate(double kxqSum, int numAtCurMin) const;
+    void computeKxqCurMin(double& kxq0, double& kxq1, int& numAtCurMin) const;
+    void computeKxqCurMin(const uint32_t* counts, double& kxq0, double& kxq1, int& numAtCurMin) const;
 
     double hipAccum;
     double kxq0;
@@ -108,6 +126,7 @@ class HllArray : public HllSketchImpl<A> {
     int curMin; //always zero for Hll6 and Hll8, only tracked by Hll4Array
     int numAtCurMin; //interpreted as num zeros when curMin == 0
     bool oooFlag; //Out-Of-Order Flag
+    bool rebuildKxqCurMinFlag; //estimator state is stale after a deferred merge
 
     friend class HllSketchImplFactory<A>;
 };
@@ -0,0 +1,136 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#ifndef _HLLREGISTEROPS_HPP_
+#define _HLLREGISTEROPS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+// SSE2 is part of the x86-64 baseline, AVX2 is detected at runtime where the compiler allows it
+#if defined(__x86_64__) || defined(_M_X64)
+#define DATASKETCHES_HLL_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define DATASKETCHES_HLL_AVX2_DISPATCH
+#include <immintrin.h>
+#endif
+#endif
+
+namespace datasketches {
+
+// Kernels over arrays of 8-bit HLL registers.
+// Each merge kernel sets dst[i] = max(dst[i], src[i]) for i in [0, n).
+
+static inline void hll_max_merge_scalar(uint8_t* dst, const uint8_t* src, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    dst[i] = src[i] > dst[i] ? src[i] : dst[i];
+  }
+}
+
+#ifdef DATASKETCHES_HLL_SSE2
+static inline void hll_max_merge_sse2(uint8_t* dst, const uint8_t* src, size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m128i old_values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    const __m128i new_values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_max_epu8(old_values, new_values));
+  }
+  hll_max_merge_scalar(dst + i, src + i, n - i);
+}
+#endif
+
+#ifdef DATASKETCHES_HLL_AVX2_DISPATCH
+__attribute__((target("avx2")))
+static inline void hll_max_merge_avx2(uint8_t* dst, const uint8_t* src, size_t n) {
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i old_values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+    const __m256i new_values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_max_epu8(old_values, new_values));
+  }
+  hll_max_merge_scalar(dst + i, src + i, n - i);
+}
+
+static inline bool hll_has_avx2() {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+#endif
+
+static inline void hll_max_merge(uint8_t* dst, const uint8_t* src, size_t n) {
+#if defined(DATASKETCHES_HLL_AVX2_DISPATCH)
+  if (hll_has_avx2()) {
+    hll_max_merge_avx2(dst, src, n);
+    return;
+  }
+#endif
+#if defined(DATASKETCHES_HLL_SSE2)
+  hll_max_merge_sse2(dst, src, n);
+#else
+  hll_max_merge_scalar(dst, src, n);
+#endif
+}
+
+// Counts occurrences of each register value into counts[0..63], which must be zeroed by the caller.
+// Four interleaved tables keep runs of equal values from serializing on a single counter.
+static inline void hll_histogram(const uint8_t* values, size_t n, uint32_t* counts) {
+  uint32_t partial[4][64] = {{0}};
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    partial[0][values[i] & 0x3f]++;
+    partial[1][values[i + 1] & 0x3f]++;
+    partial[2][values[i + 2] & 0x3f]++;
+    partial[3][values[i + 3] & 0x3f]++;
+  }
+  for (; i < n; ++i) partial[0][values[i] & 0x3f]++;
+  for (size_t v = 0; v < 64; ++v) {
+    counts[v] += partial[0][v] + partial[1][v] + partial[2][v] + partial[3][v];
+  }
+}
+
+// Unpackers of HLL_4 and HLL_6 register arrays into 8-bit registers.
+// Written without branches so that the compiler can vectorize them.
+
+// unpacks n (even) 4-bit registers starting at slot start (even) and adds offset to each
+static inline void hll_unpack4(const uint8_t* array, size_t start, size_t n, uint8_t offset, uint8_t* dst) {
+  const uint8_t* bytes = array + (start >> 1);
+  for (size_t i = 0; i < (n >> 1); ++i) {
+    dst[2 * i] = (bytes[i] & 0x0f) + offset;
+    dst[2 * i + 1] = (bytes[i] >> 4) + offset;
+  }
+}
+
+// unpacks n (multiple of 4) 6-bit registers starting at slot start (multiple of 4)
+static inline void hll_unpack6(const uint8_t* array, size_t start, size_t n, uint8_t* dst) {
+  // 4 registers occupy 3 bytes
+  const uint8_t* bytes = array + (start >> 2) * 3;
+  for (size_t i = 0; i < (n >> 2); ++i) {
+    const uint32_t word = bytes[3 * i] | (bytes[3 * i + 1] << 8) | (bytes[3 * i + 2] << 16);
+    dst[4 * i] = word & 0x3f;
+    dst[4 * i + 1] = (word >> 6) & 0x3f;
+    dst[4 * i + 2] = (word >> 12) & 0x3f;
+    dst[4 * i + 3] = (word >> 18) & 0x3f;
+  }
+}
+
+}
+
+#endif // _HLLREGISTEROPS_HPP_
@@ -211,6 +211,52 @@ void hll_sketch_alloc<A>::update(const void* data, const size_t lengthBytes) {
   coupon_update(HllUtil<A>::coupon(hashResult));
 }
 
+template<typename A>
+void hll_sketch_alloc<A>::update_batch(const uint64_t* data, size_t size) {
+  int coupons[UPDATE_BATCH_SIZE];
+  while (size > 0) {
+    const size_t block_size = size < UPDATE_BATCH_SIZE ? size : UPDATE_BATCH_SIZE;
+    for (size_t i = 0; i < block_size; ++i) {
+      HashState hashResult;
+      HllUtil<A>::hash(&data[i], sizeof(uint64_t), DEFAULT_SEED, hashResult);
+      coupons[i] = HllUtil<A>::coupon(hashResult);
+    }
+    coupon_update(coupons, block_size);
+    data += block_size;
+    size -= block_size;
+  }
+}
+
+template<typename A>
+void hll_sketch_alloc<A>::update_batch(const std::string* data, size_t size) {
+  int coupons[UPDATE_BATCH_SIZE];
+  while (size > 0) {
+    const size_t block_size = size < UPDATE_BATCH_SIZE ? size : UPDATE_BATCH_SIZE;
+    size_t num_coupons = 0;
+    for (size_t i = 0; i < block_size; ++i) {
+      if (data[i].empty()) { continue; }
+      HashState hashResult;
+      HllUtil<A>::hash(data[i].c_str(), data[i].length(), DEFAULT_SEED, hashResult);
+      coupons[num_coupons++] = HllUtil<A>::coupon(hashResult);
+    }
+    coupon_update(coupons, num_coupons);
+    data += block_size;
+    size -= block_size;
+  }
+}
+
+template<typename A>
+void hll_sketch_alloc<A>::coupon_update(const int* coupons, size_t size) {
+  // list and set are small and may change mode, so they take one coupon at a time
+  size_t i = 0;
+  for (; (i < size) && (get_current_mode() != HLL); ++i) {
+    coupon_update(coupons[i]);
+  }
+  if (i < size) {
+    static_cast<HllArray<A>*>(sketch_impl)->batchCouponUpdate(coupons + i, static_cast<int>(size - i));
+  }
+}
+
 template<typename A>
 void hll_sketch_alloc<A>::coupon_update(int coupon) {
   if (coupon == HllUtil<A>::EMPTY) { return; }
@@ -69,9 +69,10 @@ class HllSketchImpl {
     virtual A getAllocator() const = 0;
     bool isStartFullSize() const;
 
-  protected:
     static target_hll_type extractTgtHllType(uint8_t modeByte);
     static hll_mode extractCurMode(uint8_t modeByte);
+
+  protected:
     uint8_t makeFlagsByte(bool compact) const;
     uint8_t makeModeByte() const;
 
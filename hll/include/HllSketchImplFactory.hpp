@@ -164,6 +164,7 @@ Hll8Array<A>* HllSketchImplFactory<A>::convertToHll8(const HllArray<A>& srcHllAr
       Hll8Array<A>(lgConfigK, srcHllArr.isStartFullSize(), srcHllArr.getAllocator());
   hll8Array->putOutOfOrderFlag(srcHllArr.isOutOfOrderFlag());
   hll8Array->mergeHll(srcHllArr);
+  hll8Array->rebuildKxqCurMin();
   hll8Array->putHipAccum(srcHllArr.getHipAccum());
   return hll8Array;
 }
@@ -25,9 +25,15 @@
 #include "HllSketchImpl.hpp"
 #include "HllArray.hpp"
 #include "HllUtil.hpp"
+#include "HllRegisterOps.hpp"
+#include "run_threads.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace datasketches {
 
@@ -39,7 +45,9 @@ hll_union_alloc<A>::hll_union_alloc(const int lg_max_k, const A& allocator):
 
 template<typename A>
 hll_sketch_alloc<A> hll_union_alloc<A>::get_result(target_hll_type target_type) const {
-  return hll_sketch_alloc<A>(gadget, target_type);
+  hll_sketch_alloc<A> result(gadget, target_type);
+  check_rebuild_kxq_cur_min(result);
+  return result;
 }
 
 template<typename A>
@@ -59,6 +67,197 @@ void hll_union_alloc<A>::update(hll_sketch_alloc<A>&& sketch) {
   union_impl(sketch, lg_max_k);
 }
 
+template<typename A>
+void hll_union_alloc<A>::update_serialized(const void* bytes, size_t size) {
+  if (size < static_cast<size_t>(HllUtil<A>::EMPTY_SKETCH_SIZE_BYTES)) {
+    throw std::out_of_range("Input data length insufficient to hold HLL sketch");
+  }
+  const uint8_t* data = static_cast<const uint8_t*>(bytes);
+  if (data[HllUtil<A>::SER_VER_BYTE] != HllUtil<A>::SER_VER) {
+    throw std::invalid_argument("Wrong ser ver in input stream");
+  }
+  if (data[HllUtil<A>::FAMILY_BYTE] != HllUtil<A>::FAMILY_ID) {
+    throw std::invalid_argument("Input array is not an HLL sketch");
+  }
+  const hll_mode mode = HllSketchImpl<A>::extractCurMode(data[HllUtil<A>::MODE_BYTE]);
+  const target_hll_type tgt_type = HllSketchImpl<A>::extractTgtHllType(data[HllUtil<A>::MODE_BYTE]);
+  const int lg_k = HllUtil<A>::checkLgK(data[HllUtil<A>::LG_K_BYTE]);
+  const bool compact = (data[HllUtil<A>::FLAGS_BYTE] & HllUtil<A>::COMPACT_FLAG_MASK) ? true : false;
+  const int expected_pre_ints = mode == LIST ? HllUtil<A>::LIST_PREINTS
+      : mode == SET ? HllUtil<A>::HASH_SET_PREINTS : HllUtil<A>::HLL_PREINTS;
+  if (data[HllUtil<A>::PREAMBLE_INTS_BYTE] != expected_pre_ints) {
+    throw std::invalid_argument("Incorrect number of preInts in input stream");
+  }
+  HllSketchImpl<A>* dst_impl = gadget.sketch_impl;
+
+  if (mode == LIST || mode == SET) {
+    if (dst_impl->isEmpty() && lg_k == dst_impl->getLgConfigK()) {
+      // the gadget becomes a copy of the input
+      update(hll_sketch_alloc<A>::deserialize(bytes, size, dst_impl->getAllocator()));
+      return;
+    }
+    int coupon_count;
+    int coupons_in_array;
+    size_t offset;
+    if (mode == LIST) {
+      coupon_count = data[HllUtil<A>::LIST_COUNT_BYTE];
+      // coupons of a list are packed at the beginning of the array
+      coupons_in_array = coupon_count;
+      offset = HllUtil<A>::LIST_INT_ARR_START;
+    } else {
+      if (size < static_cast<size_t>(HllUtil<A>::HASH_SET_INT_ARR_START)) {
+        throw std::out_of_range("Input data length insufficient to hold CouponHashSet");
+      }
+      std::memcpy(&coupon_count, data + HllUtil<A>::HASH_SET_COUNT_INT, sizeof(coupon_count));
+      int lg_arr_ints = data[HllUtil<A>::LG_ARR_BYTE];
+      if (lg_arr_ints < HllUtil<A>::LG_INIT_SET_SIZE) {
+        lg_arr_ints = HllUtil<A>::computeLgArrInts(SET, coupon_count, lg_k);
+      }
+      coupons_in_array = compact ? coupon_count : 1 << lg_arr_ints;
+      offset = HllUtil<A>::HASH_SET_INT_ARR_START;
+    }
+    const size_t expected_size = offset + coupons_in_array * sizeof(int);
+    if (size < expected_size) {
+      throw std::out_of_range("Byte array too short for sketch. Expected " + std::to_string(expected_size)
+                                  + ", found: " + std::to_string(size));
+    }
+    merge_serialized_coupons(data + offset, coupons_in_array);
+    return;
+  }
+
+  // HLL mode
+  const int array_bytes = HllArray<A>::hllArrBytes(tgt_type, lg_k);
+  if (size < static_cast<size_t>(HllUtil<A>::HLL_BYTE_ARR_START + array_bytes)) {
+    throw std::out_of_range("Input array too small to hold sketch image");
+  }
+  const int cur_min = data[HllUtil<A>::HLL_CUR_MIN_BYTE];
+  int num_at_cur_min;
+  std::memcpy(&num_at_cur_min, data + HllUtil<A>::CUR_MIN_COUNT_INT, sizeof(num_at_cur_min));
+  if (cur_min == 0 && num_at_cur_min == (1 << lg_k)) return; // empty
+  int aux_count;
+  std::memcpy(&aux_count, data + HllUtil<A>::AUX_COUNT_INT, sizeof(aux_count));
+  const int aux_ints = aux_count == 0 ? 0 : compact ? aux_count : 1 << data[HllUtil<A>::LG_ARR_BYTE];
+  const size_t aux_offset = HllUtil<A>::HLL_BYTE_ARR_START + array_bytes;
+  if (size < aux_offset + aux_ints * sizeof(int)) {
+    throw std::out_of_range("Input array too small to hold AuxHashMap image");
+  }
+  if (dst_impl->getCurMode() != HLL) {
+    // the gadget becomes a copy of the input, possibly downsampled
+    update(hll_sketch_alloc<A>::deserialize(bytes, size, dst_impl->getAllocator()));
+    return;
+  }
+  if (lg_k < dst_impl->getLgConfigK()) {
+    dst_impl = copy_or_downsample(dst_impl, lg_k);
+    gadget.sketch_impl->get_deleter()(gadget.sketch_impl); // gadget to be replaced
+    gadget.sketch_impl = dst_impl; // gadget replaced
+  }
+  Hll8Array<A>* dst = static_cast<Hll8Array<A>*>(dst_impl);
+  dst->mergeHllBytes(data + HllUtil<A>::HLL_BYTE_ARR_START, lg_k, tgt_type, cur_min, 0, 1 << dst->getLgConfigK());
+  const uint8_t* aux_data = data + aux_offset;
+  for (int i = 0; i < aux_ints; ++i, aux_data += sizeof(int)) {
+    int coupon;
+    std::memcpy(&coupon, aux_data, sizeof(coupon));
+    if (coupon != HllUtil<A>::EMPTY) dst->mergeCoupon(coupon);
+  }
+  dst->putOutOfOrderFlag(true);
+  dst->putHipAccum(0);
+  // kxq and numAtCurMin are recomputed when the result is taken
+  dst->putRebuildKxqCurMinFlag(true);
+}
+
+template<typename A>
+template<typename ForwardIt>
+void hll_union_alloc<A>::update_all(ForwardIt first, ForwardIt last, unsigned num_threads) {
+  if (num_threads == 0) throw std::invalid_argument("number of threads must be positive");
+  std::vector<const HllArray<A>*> arrays;
+  std::vector<const CouponList<A>*> lists;
+  int lg_k = gadget.get_lg_config_k();
+  for (auto it = first; it != last; ++it) {
+    const HllSketchImpl<A>* impl = it->sketch_impl;
+    if (impl->isEmpty()) continue;
+    if (impl->getCurMode() == HLL) {
+      arrays.push_back(static_cast<const HllArray<A>*>(impl));
+      lg_k = std::min(lg_k, impl->getLgConfigK());
+    } else {
+      lists.push_back(static_cast<const CouponList<A>*>(impl));
+    }
+  }
+  const int num_stripes = 1 << std::max(0, lg_k - LG_STRIPE_SIZE);
+  num_threads = std::min<unsigned>(num_threads, num_stripes);
+  if (num_threads <= 1 || arrays.size() < 2) {
+    for (auto it = first; it != last; ++it) {
+      if (!it->is_empty()) union_impl(*it, lg_max_k);
+    }
+    return;
+  }
+
+  // the result is in HLL mode with the smallest lg_k of the gadget and the HLL inputs
+  HllSketchImpl<A>* dst_impl = gadget.sketch_impl;
+  if (dst_impl->getCurMode() == HLL) {
+    if (lg_k < dst_impl->getLgConfigK()) {
+      dst_impl = copy_or_downsample(dst_impl, lg_k);
+      gadget.sketch_impl->get_deleter()(gadget.sketch_impl); // gadget to be replaced
+    }
+  } else {
+    typedef typename std::allocator_traits<A>::template rebind_alloc<Hll8Array<A>> hll8Alloc;
+    const A allocator = dst_impl->getAllocator();
+    Hll8Array<A>* array = new (hll8Alloc(allocator).allocate(1)) Hll8Array<A>(lg_k, false, allocator);
+    array->mergeList(*static_cast<const CouponList<A>*>(dst_impl));
+    gadget.sketch_impl->get_deleter()(gadget.sketch_impl); // gadget to be replaced
+    dst_impl = array;
+  }
+  gadget.sketch_impl = dst_impl; // gadget replaced
+  Hll8Array<A>* dst = static_cast<Hll8Array<A>*>(dst_impl);
+
+  // stripes are handed out on demand, each thread keeps a histogram of the stripes it merged
+  const int stripe_size = (1 << lg_k) / num_stripes;
+  const int dst_mask = (1 << lg_k) - 1;
+  std::atomic<int> next_stripe(0);
+  std::vector<uint32_t> counts(num_threads * 64, 0);
+  run_threads(num_threads, [&](unsigned t) {
+    while (true) {
+      const int stripe = next_stripe.fetch_add(1);
+      if (stripe >= num_stripes) break;
+      const int start = stripe * stripe_size;
+      const int end = start + stripe_size;
+      auto merge_coupon_in_stripe = [&](int coupon) {
+        const int slot = HllUtil<A>::getLow26(coupon) & dst_mask;
+        if (slot >= start && slot < end) dst->mergeCoupon(coupon);
+      };
+      for (const HllArray<A>* src: arrays) {
+        dst->mergeHllBytes(src->getHllByteArr(), src->getLgConfigK(), src->getTgtHllType(), src->getCurMin(), start, end);
+        const AuxHashMap<A>* aux_map = src->getAuxHashMap();
+        if (aux_map != nullptr) {
+          for (auto coupon: *aux_map) merge_coupon_in_stripe(coupon);
+        }
+      }
+      for (const CouponList<A>* src: lists) {
+        for (auto coupon: *src) merge_coupon_in_stripe(coupon);
+      }
+      hll_histogram(dst->getHllByteArr() + start, stripe_size, counts.data() + t * 64);
+    }
+  });
+
+  for (unsigned t = 1; t < num_threads; ++t) {
+    for (int v = 0; v < 64; ++v) counts[v] += counts[t * 64 + v];
+  }
+  dst->rebuildKxqCurMin(counts.data());
+  dst->putOutOfOrderFlag(true);
+  dst->putHipAccum(0);
+}
+
+template<typename A>
+void hll_union_alloc<A>::merge_serialized_coupons(const uint8_t* data, int num_coupons) {
+  HllSketchImpl<A>* dst_impl = gadget.sketch_impl;
+  for (int i = 0; i < num_coupons; ++i, data += sizeof(int)) {
+    int coupon;
+    std::memcpy(&coupon, data, sizeof(coupon));
+    if (coupon == HllUtil<A>::EMPTY) { continue; }
+    dst_impl = leak_free_coupon_update(dst_impl, coupon); //assignment required
+  }
+  gadget.sketch_impl = dst_impl;
+}
+
 template<typename A>
 void hll_union_alloc<A>::update(const std::string& datum) {
   gadget.update(datum);
@@ -203,12 +402,20 @@ HllSketchImpl<A>* hll_union_alloc<A>::copy_or_downsample(const HllSketchImpl<A>*
   typedef typename std::allocator_traits<A>::template rebind_alloc<Hll8Array<A>> hll8Alloc;
   Hll8Array<A>* tgtHllArr = new (hll8Alloc(src->getAllocator()).allocate(1)) Hll8Array<A>(tgt_lg_k, false, src->getAllocator());
   tgtHllArr->mergeHll(*src);
+  tgtHllArr->rebuildKxqCurMin();
   //both of these are required for isomorphism
   tgtHllArr->putHipAccum(src->getHipAccum());
   tgtHllArr->putOutOfOrderFlag(src->isOutOfOrderFlag());
   return tgtHllArr;
 }
 
+template<typename A>
+void hll_union_alloc<A>::check_rebuild_kxq_cur_min(hll_sketch_alloc<A>& sketch) {
+  if (sketch.sketch_impl->getCurMode() != HLL) return;
+  HllArray<A>* array = static_cast<HllArray<A>*>(sketch.sketch_impl);
+  if (array->isRebuildKxqCurMinFlag()) array->rebuildKxqCurMin();
+}
+
 template<typename A>
 inline HllSketchImpl<A>* hll_union_alloc<A>::leak_free_coupon_update(HllSketchImpl<A>* impl, const int coupon) {
   HllSketchImpl<A>* result = impl->couponUpdate(coupon);
@@ -249,6 +456,8 @@ void hll_union_alloc<A>::union_impl(const hll_sketch_alloc<A>& sketch, const int
       static_cast<Hll8Array<A>*>(dst_impl)->mergeHll(*src);
       dst_impl->putOutOfOrderFlag(true);
       static_cast<Hll8Array<A>*>(dst_impl)->putHipAccum(0);
+      // kxq and numAtCurMin are recomputed when the union is queried or the result is taken
+      static_cast<Hll8Array<A>*>(dst_impl)->putRebuildKxqCurMinFlag(true);
     }
   } else { // src is HLL, gadget is empty
     dst_impl = copy_or_downsample(src_impl, lg_max_k);
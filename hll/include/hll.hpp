@@ -281,6 +281,23 @@ class hll_sketch_alloc final {
      */
     void update(const void* data, size_t length_bytes);
 
+    /**
+     * Present each of the given unsigned 64-bit integers as a potential unique item.
+     * The result is the same as calling update() for each of them, but the items are hashed in blocks
+     * and the registers they map to are prefetched, which helps sketches that do not fit in the cache.
+     * @param data The given array of integers.
+     * @param size The number of integers.
+     */
+    void update_batch(const uint64_t* data, size_t size);
+
+    /**
+     * Present each of the given strings as a potential unique item.
+     * The result is the same as calling update() for each of them, so empty strings are skipped.
+     * @param data The given array of strings.
+     * @param size The number of strings.
+     */
+    void update_batch(const std::string* data, size_t size);
+
     /**
      * Returns the current cardinality estimate
      * @return the cardinality estimate
@@ -381,7 +398,10 @@ class hll_sketch_alloc final {
   private:
     explicit hll_sketch_alloc(HllSketchImpl<A>* that);
 
+    static const size_t UPDATE_BATCH_SIZE = 64;
+
     void coupon_update(int coupon);
+    void coupon_update(const int* coupons, size_t size);
 
     std::string type_as_string() const;
     std::string mode_as_string() const;
@@ -418,6 +438,10 @@ class hll_sketch_alloc final {
  * <p>Second, the internal effective value of log-base-2 of <i>k</i> for the union operation can
  * change dynamically based on the smallest <i>lg_config_k</i> that the union operation has seen.
  *
+ * <p>Merging a sketch updates only the registers. The estimator state is computed from a histogram
+ * of the registers when the union is queried, without changing the union, and once more for the
+ * sketch returned by get_result(). Read the estimate once after merging all of the sketches.
+ *
  * author Jon Malkin
  * author Lee Rhodes
  * author Kevin Lang
@@ -511,6 +535,31 @@ class hll_union_alloc {
      * @param The given sketch.
      */
     void update(hll_sketch_alloc<A>&& sketch);
+
+    /**
+     * Update this union with a serialized sketch, compact or updatable.
+     * The result is the same as updating with the deserialized sketch. Coupons or registers
+     * are merged directly from the given bytes. The sketch is deserialized only where the union
+     * would replace its internal state with a copy of it anyway: an HLL sketch given to a union
+     * that is not in HLL mode yet, or a LIST or SET sketch with the same lg_k given to an empty union.
+     * @param bytes the serialized sketch
+     * @param size the size of the serialized sketch in bytes
+     */
+    void update_serialized(const void* bytes, size_t size);
+
+    /**
+     * Update this union with a range of sketches using up to the given number of threads.
+     * The register array of the union is split into stripes of 2^14 registers, and each thread
+     * merges all of the sketches into the stripes it owns, so threads never write to the same registers.
+     * The estimator state is rebuilt at the end from histograms computed per stripe.
+     * The estimate is the same as updating with each sketch in turn. The sketches are merged on the
+     * calling thread if fewer than two of them are in HLL mode or the union has fewer than two stripes.
+     * @param first iterator to the first sketch
+     * @param last iterator past the last sketch
+     * @param num_threads maximum number of threads to use
+     */
+    template<typename ForwardIt>
+    void update_all(ForwardIt first, ForwardIt last, unsigned num_threads);
   
     /**
      * Present the given std::string as a potential unique item.
@@ -615,6 +664,15 @@ class hll_union_alloc {
 
     static HllSketchImpl<A>* copy_or_downsample(const HllSketchImpl<A>* src_impl, int tgt_lg_k);
 
+    // log2 of the number of registers merged by one thread at a time in update_all()
+    static const int LG_STRIPE_SIZE = 14;
+
+    // merges coupons read from a serialized LIST or SET, skipping empty slots
+    void merge_serialized_coupons(const uint8_t* data, int num_coupons);
+
+    // recomputes the estimator state deferred by merges, for a result copied from the gadget
+    static void check_rebuild_kxq_cur_min(hll_sketch_alloc<A>& sketch);
+
     void coupon_update(int coupon);
 
     hll_mode get_current_mode() const;
@@ -45,6 +45,36 @@ TEST_CASE("hll array: check composite estimate", "[hll_array]") {
   testComposite(13, target_hll_type::HLL_8, 10000);
 }
 
+static void checkRebuildKxqCurMin(const int lgK, const target_hll_type tgtHllType, const int n) {
+  hll_sketch sk(lgK, tgtHllType);
+  for (int i = 0; i < n; ++i) sk.update(i);
+  auto bytes = sk.serialize_updatable();
+  HllArray<std::allocator<uint8_t>>* array = HllArray<std::allocator<uint8_t>>::newHll(bytes.data(), bytes.size(), std::allocator<uint8_t>());
+  const double kxq0 = array->getKxQ0();
+  const double kxq1 = array->getKxQ1();
+  const int curMin = array->getCurMin();
+  const int numAtCurMin = array->getNumAtCurMin();
+  array->putKxQ0(0);
+  array->putKxQ1(0);
+  array->putNumAtCurMin(0);
+  array->rebuildKxqCurMin();
+  // histogram sums must match the incrementally maintained values exactly
+  REQUIRE(array->getKxQ0() == kxq0);
+  REQUIRE(array->getKxQ1() == kxq1);
+  REQUIRE(array->getCurMin() == curMin);
+  REQUIRE(array->getNumAtCurMin() == numAtCurMin);
+  array->get_deleter()(array);
+}
+
+TEST_CASE("hll array: check rebuild kxq and cur min", "[hll_array]") {
+  checkRebuildKxqCurMin(4, target_hll_type::HLL_4, 100);
+  checkRebuildKxqCurMin(8, target_hll_type::HLL_4, 100000);
+  checkRebuildKxqCurMin(8, target_hll_type::HLL_6, 100000);
+  checkRebuildKxqCurMin(8, target_hll_type::HLL_8, 100000);
+  checkRebuildKxqCurMin(13, target_hll_type::HLL_4, 1000);
+  checkRebuildKxqCurMin(13, target_hll_type::HLL_8, 10000000);
+}
+
 static void serializeDeserialize(const int lgK, target_hll_type tgtHllType, const int n) {
   hll_sketch sk1(lgK, tgtHllType);
 
@@ -19,6 +19,9 @@
 
 #include "hll.hpp"
 
+#include <string>
+#include <vector>
+
 #include <catch.hpp>
 #include <test_allocator.hpp>
 
@@ -286,6 +289,37 @@ TEST_CASE("hll sketch: check input types", "[hll_sketch]") {
   REQUIRE(test_allocator_total_bytes == 0);
 }
 
+TEST_CASE("hll sketch: batch update", "[hll_sketch]") {
+  test_allocator_total_bytes = 0;
+  {
+    // sizes cover list, set and HLL modes, and a size that is not a multiple of the batch
+    std::vector<uint64_t> values;
+    std::vector<std::string> strings;
+    for (uint64_t i = 0; i < 10001; ++i) {
+      values.push_back(i * 0x9E3779B97F4A7C15ULL);
+      strings.push_back(i % 97 == 0 ? std::string() : std::to_string(i));
+    }
+    for (target_hll_type type: {HLL_4, HLL_6, HLL_8}) {
+      for (size_t n: {5, 100, 10001}) {
+        hll_sketch_test_alloc sk1(10, type, false, 0);
+        hll_sketch_test_alloc sk2(10, type, false, 0);
+        for (size_t i = 0; i < n; ++i) sk1.update(values[i]);
+        sk2.update_batch(values.data(), n);
+        REQUIRE(sk1.serialize_updatable() == sk2.serialize_updatable());
+        REQUIRE(sk1.get_estimate() == sk2.get_estimate());
+
+        hll_sketch_test_alloc sk3(10, type, false, 0);
+        hll_sketch_test_alloc sk4(10, type, false, 0);
+        for (size_t i = 0; i < n; ++i) sk3.update(strings[i]);
+        sk4.update_batch(strings.data(), n);
+        REQUIRE(sk3.serialize_updatable() == sk4.serialize_updatable());
+        REQUIRE(sk3.get_estimate() == sk4.get_estimate());
+      }
+    }
+  }
+  REQUIRE(test_allocator_total_bytes == 0);
+}
+
 TEST_CASE("hll sketch: deserialize list mode buffer overrun", "[hll_sketch]") {
   test_allocator_total_bytes = 0;
   {
@@ -18,7 +18,9 @@
  */
 
 #include <catch.hpp>
+#include <algorithm>
 #include <sstream>
+#include <vector>
 
 #include "hll.hpp"
 
@@ -310,4 +312,128 @@ TEST_CASE("hll union: check hll to hll", "[hll_union]") {
   union_two_sketches_with_overlap(1000000, 11, HLL_4);
 }
 
+TEST_CASE("hll union: merged registers match single sketch", "[hll_union]") {
+  // the union must see every type of source register array, with downsampling
+  const int n = 200000;
+  hll_sketch sketch4(10, HLL_4);
+  hll_sketch sketch6(11, HLL_6);
+  hll_sketch sketch8(12, HLL_8);
+  hll_sketch control(10, HLL_8);
+  for (int key = 0; key < n; key++) {
+    if (key % 3 == 0) sketch4.update(key);
+    else if (key % 3 == 1) sketch6.update(key);
+    else sketch8.update(key);
+    control.update(key);
+  }
+
+  hll_union u(10);
+  u.update(sketch4);
+  u.update(sketch6);
+  u.update(sketch8);
+  // queries compute the deferred estimator state without changing the union
+  const double union_estimate = u.get_composite_estimate();
+  const double union_lower_bound = u.get_lower_bound(1);
+  REQUIRE(u.get_composite_estimate() == union_estimate);
+  hll_sketch result = u.get_result(HLL_8);
+  REQUIRE(result.get_composite_estimate() == union_estimate);
+  REQUIRE(result.get_lower_bound(1) == union_lower_bound);
+
+  auto result_bytes = result.serialize_compact();
+  auto control_bytes = control.serialize_compact();
+  REQUIRE(result_bytes.size() == control_bytes.size());
+  const int start = HllUtil<>::HLL_BYTE_ARR_START;
+  for (size_t i = start; i < result_bytes.size(); i++) {
+    REQUIRE(result_bytes[i] == control_bytes[i]);
+  }
+  REQUIRE(result.get_composite_estimate() == Approx(control.get_composite_estimate()).epsilon(1e-9));
+}
+
+TEST_CASE("hll union: update serialized", "[hll_union]") {
+  // inputs in every mode and type, with lg_k below, equal to and above lg_max_k of the union
+  std::vector<hll_sketch> sketches;
+  int key = 0;
+  for (int n: {0, 5, 200, 1000000}) {
+    for (target_hll_type type: {HLL_4, HLL_6, HLL_8}) {
+      for (int lg_k: {8, 10, 12}) {
+        hll_sketch sketch(lg_k, type);
+        for (int i = 0; i < n; i++) sketch.update(key++);
+        key -= n / 2; // overlap with the next sketch
+        sketches.push_back(std::move(sketch));
+      }
+    }
+  }
+  // in forward order the union goes through LIST and SET, in reverse it starts with HLL
+  for (bool reverse: {false, true}) {
+    if (reverse) std::reverse(sketches.begin(), sketches.end());
+    hll_union u1(10);
+    hll_union u2(10);
+    bool compact = false;
+    for (const auto& sketch: sketches) {
+      compact = !compact;
+      auto bytes = compact ? sketch.serialize_compact() : sketch.serialize_updatable();
+      u1.update(hll_sketch::deserialize(bytes.data(), bytes.size()));
+      u2.update_serialized(bytes.data(), bytes.size());
+      REQUIRE(u2.get_lg_config_k() == u1.get_lg_config_k());
+      REQUIRE(u2.get_estimate() == Approx(u1.get_estimate()).epsilon(1e-9));
+    }
+    auto bytes1 = u1.get_result(HLL_8).serialize_updatable();
+    auto bytes2 = u2.get_result(HLL_8).serialize_updatable();
+    REQUIRE(bytes1 == bytes2);
+  }
+
+  hll_union u(10);
+  const uint8_t bad_family[8] = {2, 1, 3, 10, 3, 8, 0, 0};
+  REQUIRE_THROWS_AS(u.update_serialized(bad_family, 8), std::invalid_argument);
+  REQUIRE_THROWS_AS(u.update_serialized(bad_family, 4), std::out_of_range);
+  auto bytes = sketches.front().serialize_compact();
+  REQUIRE_THROWS_AS(u.update_serialized(bytes.data(), bytes.size() - 1), std::out_of_range);
+}
+
+TEST_CASE("hll union: update all", "[hll_union]") {
+  std::vector<hll_sketch> sketches;
+  uint64_t key = 0;
+  const target_hll_type types[] = {HLL_4, HLL_6, HLL_8};
+  const int lg_ks[] = {17, 16, 18};
+  for (int i = 0; i < 12; ++i) {
+    // mostly HLL mode with some LIST, SET and empty sketches mixed in
+    const uint64_t n = i % 4 == 3 ? (i % 3) * 500 : 200000;
+    hll_sketch sketch(lg_ks[i % 3], types[i % 3]);
+    for (uint64_t j = 0; j < n; ++j) sketch.update(key++);
+    key -= n / 2; // overlap with the next sketch
+    sketches.push_back(std::move(sketch));
+  }
+
+  for (int lg_max_k: {12, 16, 17}) {
+    for (unsigned num_threads: {1, 2, 3, 8}) {
+      // the union starts empty, in LIST or SET mode or in HLL mode
+      for (uint64_t n0: {0, 5, 1000, 100000}) {
+        hll_union u1(lg_max_k);
+        hll_union u2(lg_max_k);
+        for (uint64_t j = 0; j < n0; ++j) {
+          u1.update(j);
+          u2.update(j);
+        }
+        for (const auto& sketch: sketches) u1.update(sketch);
+        u2.update_all(sketches.begin(), sketches.end(), num_threads);
+        REQUIRE(u2.get_lg_config_k() == u1.get_lg_config_k());
+        REQUIRE(u2.get_estimate() == Approx(u1.get_estimate()).epsilon(1e-9));
+        REQUIRE(u2.get_result(HLL_8).serialize_updatable() == u1.get_result(HLL_8).serialize_updatable());
+      }
+    }
+  }
+
+  // a lower lg_k of one input downsamples the result
+  hll_sketch small(13, HLL_4);
+  for (int i = 0; i < 100000; ++i) small.update(i);
+  sketches.push_back(std::move(small));
+  hll_union u1(16);
+  for (const auto& sketch: sketches) u1.update(sketch);
+  hll_union u2(16);
+  u2.update_all(sketches.begin(), sketches.end(), 4);
+  REQUIRE(u2.get_lg_config_k() == 13);
+  REQUIRE(u2.get_result(HLL_8).serialize_updatable() == u1.get_result(HLL_8).serialize_updatable());
+
+  REQUIRE_THROWS_AS(u2.update_all(sketches.begin(), sketches.end(), 0), std::invalid_argument);
+}
+
 } /* namespace datasketches */
@@ -20,18 +20,98 @@
 #ifndef KLL_HELPER_HPP_
 #define KLL_HELPER_HPP_
 
-#include <random>
+#include <algorithm>
+#include <cstdint>
 #include <stdexcept>
 #include <chrono>
+#include <thread>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "common_defs.hpp"
 
 namespace datasketches {
 
-static std::independent_bits_engine<std::mt19937, 1, uint32_t> random_bit(std::chrono::system_clock::now().time_since_epoch().count());
+/*
+ * Source of random bits for compaction.
+ * Each sketch owns an instance so that independent sketches can be updated from different threads.
+ * Bits are drawn 64 at a time from a splitmix64 sequence, so the state is a few words.
+ * Unless seeded explicitly, an instance takes its seed from a per-thread sequence,
+ * which is initialized from the clock and the thread id.
+ * A copy of an unseeded instance takes a new seed from that sequence, so that copies of
+ * one prototype draw independent bits. A copy of a seeded instance continues the same sequence.
+ * Moves keep the state.
+ */
+class kll_random_bits {
+public:
+  kll_random_bits(): state_(next_seed()), bits_(0), num_bits_(0), seeded_(false) {}
+  explicit kll_random_bits(uint64_t seed): state_(seed), bits_(0), num_bits_(0), seeded_(true) {}
+
+  kll_random_bits(const kll_random_bits& other):
+    state_(other.seeded_ ? other.state_ : next_seed()),
+    bits_(other.seeded_ ? other.bits_ : 0),
+    num_bits_(other.seeded_ ? other.num_bits_ : 0),
+    seeded_(other.seeded_) {}
+
+  kll_random_bits(kll_random_bits&& other) = default;
+
+  kll_random_bits& operator=(const kll_random_bits& other) {
+    kll_random_bits copy(other);
+    *this = std::move(copy);
+    return *this;
+  }
+
+  kll_random_bits& operator=(kll_random_bits&& other) = default;
+
+  void seed(uint64_t seed) {
+    state_ = seed;
+    bits_ = 0;
+    num_bits_ = 0;
+    seeded_ = true;
+  }
+
+  uint32_t operator()() {
+    if (num_bits_ == 0) {
+      bits_ = splitmix64(state_);
+      num_bits_ = 64;
+    }
+    const uint32_t bit = static_cast<uint32_t>(bits_ & 1);
+    bits_ >>= 1;
+    --num_bits_;
+    return bit;
+  }
+
+private:
+  uint64_t state_;
+  uint64_t bits_;
+  uint8_t num_bits_;
+  bool seeded_;
+
+  static uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  static uint64_t next_seed() {
+    static thread_local uint64_t seed_state =
+        static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count())
+        ^ (static_cast<uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) << 1);
+    return splitmix64(seed_state);
+  }
+};
 
 #ifdef KLL_VALIDATION
 extern uint32_t kll_next_offset;
 #endif
 
+// float and double ordered by std::less can be sorted by their bit patterns
+template<typename T, typename C>
+struct kll_radix_sortable: std::integral_constant<bool,
+  (std::is_same<T, float>::value || std::is_same<T, double>::value) && std::is_same<C, std::less<T>>::value> {};
+
 // 0 <= power <= 30
 static const uint64_t powers_of_three[] =  {1, 3, 9, 27, 81, 243, 729, 2187, 6561, 19683, 59049, 177147, 531441,
 1594323, 4782969, 14348907, 43046721, 129140163, 387420489, 1162261467,
@@ -84,10 +164,25 @@ class kll_helper {
     }
 
     template <typename T>
-    static void randomly_halve_down(T* buf, uint32_t start, uint32_t length);
+    static void randomly_halve_down(T* buf, uint32_t start, uint32_t length, kll_random_bits& random_bits);
 
     template <typename T>
-    static void randomly_halve_up(T* buf, uint32_t start, uint32_t length);
+    static void randomly_halve_up(T* buf, uint32_t start, uint32_t length, kll_random_bits& random_bits);
+
+    /*
+     * Sorts items with the comparator C.
+     * Float and double ordered by std::less are sorted with an LSD radix sort on their
+     * order-preserving bit patterns, using a scratch buffer from the given allocator.
+     */
+    template <typename T, typename C, typename A>
+    static typename std::enable_if<kll_radix_sortable<T, C>::value, void>::type
+    sort_items(T* first, T* last, const A& allocator);
+
+    template <typename T, typename C, typename A>
+    static typename std::enable_if<!kll_radix_sortable<T, C>::value, void>::type
+    sort_items(T* first, T* last, const A&) {
+      std::sort(first, last, C());
+    }
 
     // this version moves objects within the same buffer
     // assumes that destination has initialized objects
@@ -125,9 +220,10 @@ class kll_helper {
      * sorted afterwards.
      * Level zero is not required to be sorted before, and may not be sorted afterwards.
      */
-    template <typename T, typename C>
+    template <typename T, typename C, typename A>
     static compress_result general_compress(uint16_t k, uint8_t m, uint8_t num_levels_in, T* items,
-            uint32_t* in_levels, uint32_t* out_levels, bool is_level_zero_sorted);
+            uint32_t* in_levels, uint32_t* out_levels, bool is_level_zero_sorted, kll_random_bits& random_bits,
+            const A& allocator);
 
     template<typename T>
     static void copy_construct(const T* src, size_t src_first, size_t src_last, T* dst, size_t dst_first);
@@ -135,8 +231,25 @@ class kll_helper {
     template<typename T>
     static void move_construct(T* src, size_t src_first, size_t src_last, T* dst, size_t dst_first, bool destroy);
 
-#ifdef KLL_VALIDATION
   private:
+    template <typename U, typename T, typename A>
+    static void radix_sort(T* first, T* last, const A& allocator);
+
+    // branch-free versions for arithmetic types
+    template <typename T, typename C>
+    static void merge_sorted_arrays(T* buf, uint32_t start_a, uint32_t len_a, uint32_t start_b, uint32_t len_b, uint32_t start_c,
+        std::true_type);
+    template <typename T, typename C>
+    static void merge_sorted_arrays(T* buf, uint32_t start_a, uint32_t len_a, uint32_t start_b, uint32_t len_b, uint32_t start_c,
+        std::false_type);
+    template <typename T, typename C>
+    static void merge_sorted_arrays(const T* buf_a, uint32_t start_a, uint32_t len_a, const T* buf_b, uint32_t start_b, uint32_t len_b,
+        T* buf_c, uint32_t start_c, std::true_type);
+    template <typename T, typename C>
+    static void merge_sorted_arrays(const T* buf_a, uint32_t start_a, uint32_t len_a, const T* buf_b, uint32_t start_b, uint32_t len_b,
+        T* buf_c, uint32_t start_c, std::false_type);
+
+#ifdef KLL_VALIDATION
 
     static inline uint32_t deterministic_offset();
 #endif
@@ -21,6 +21,8 @@
 #define KLL_HELPER_IMPL_HPP_
 
 #include <algorithm>
+#include <cstring>
+#include <vector>
 
 namespace datasketches {
 
@@ -90,35 +92,99 @@ uint64_t kll_helper::sum_the_sample_weights(uint8_t num_levels, const uint32_t*
 }
 
 template <typename T>
-void kll_helper::randomly_halve_down(T* buf, uint32_t start, uint32_t length) {
+void kll_helper::randomly_halve_down(T* buf, uint32_t start, uint32_t length, kll_random_bits& random_bits) {
   if (!is_even(length)) throw std::invalid_argument("length must be even");
   const uint32_t half_length = length / 2;
 #ifdef KLL_VALIDATION
+  unused(random_bits);
   const uint32_t offset = deterministic_offset();
 #else
-  const uint32_t offset = random_bit();
+  const uint32_t offset = random_bits();
 #endif
+  uint32_t i = start;
   uint32_t j = start + offset;
-  for (uint32_t i = start; i < (start + half_length); i++) {
-    if (i != j) buf[i] = std::move(buf[j]);
+  if (i == j) { // the first item stays in place, after that the source is always ahead
+    i++;
     j += 2;
   }
+  for (; i < (start + half_length); i++, j += 2) buf[i] = std::move(buf[j]);
 }
 
 template <typename T>
-void kll_helper::randomly_halve_up(T* buf, uint32_t start, uint32_t length) {
+void kll_helper::randomly_halve_up(T* buf, uint32_t start, uint32_t length, kll_random_bits& random_bits) {
   if (!is_even(length)) throw std::invalid_argument("length must be even");
   const uint32_t half_length = length / 2;
 #ifdef KLL_VALIDATION
+  unused(random_bits);
   const uint32_t offset = deterministic_offset();
 #else
-  const uint32_t offset = random_bit();
+  const uint32_t offset = random_bits();
 #endif
-  uint32_t j = (start + length) - 1 - offset;
-  for (uint32_t i = (start + length) - 1; i >= (start + half_length); i--) {
-    if (i != j) buf[i] = std::move(buf[j]);
+  uint32_t i = (start + length) - 1;
+  uint32_t j = i - offset;
+  if (i == j) { // the last item stays in place, after that the source is always behind
+    i--;
     j -= 2;
   }
+  for (; i >= (start + half_length); i--, j -= 2) buf[i] = std::move(buf[j]);
+}
+
+template <typename T, typename C, typename A>
+typename std::enable_if<kll_radix_sortable<T, C>::value, void>::type
+kll_helper::sort_items(T* first, T* last, const A& allocator) {
+  // below this size the histograms cost more than comparisons
+  if (last - first < 2048) {
+    std::sort(first, last, C());
+    return;
+  }
+  using U = typename std::conditional<sizeof(T) == sizeof(uint32_t), uint32_t, uint64_t>::type;
+  radix_sort<U>(first, last, allocator);
+}
+
+// LSD radix sort of floating point values (no NaN) by 8-bit digits of their bit patterns.
+// The sign bit is flipped for positive values and all bits are flipped for negative values,
+// so that the unsigned order of the patterns matches the order of the values.
+template <typename U, typename T, typename A>
+void kll_helper::radix_sort(T* first, T* last, const A& allocator) {
+  static_assert(sizeof(U) == sizeof(T), "key size mismatch");
+  const size_t n = last - first;
+  const U sign_bit = static_cast<U>(1) << (sizeof(U) * 8 - 1);
+  using AllocU = typename std::allocator_traits<A>::template rebind_alloc<U>;
+  std::vector<U, AllocU> buffer(2 * n, 0, AllocU(allocator));
+  U* keys = buffer.data();
+  U* temp = keys + n;
+
+  uint32_t counts[sizeof(U)][256] = {};
+  for (size_t i = 0; i < n; ++i) {
+    U bits;
+    std::memcpy(&bits, &first[i], sizeof(U));
+    const U key = (bits & sign_bit) ? ~bits : bits | sign_bit;
+    keys[i] = key;
+    for (unsigned d = 0; d < sizeof(U); ++d) ++counts[d][(key >> (d * 8)) & 0xff];
+  }
+
+  for (unsigned d = 0; d < sizeof(U); ++d) {
+    uint32_t* count = counts[d];
+    // skip the digit if all keys share it
+    if (count[(keys[0] >> (d * 8)) & 0xff] == n) continue;
+    uint32_t offset = 0;
+    for (unsigned b = 0; b < 256; ++b) {
+      const uint32_t c = count[b];
+      count[b] = offset;
+      offset += c;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      const U key = keys[i];
+      temp[count[(key >> (d * 8)) & 0xff]++] = key;
+    }
+    std::swap(keys, temp);
+  }
+
+  for (size_t i = 0; i < n; ++i) {
+    const U key = keys[i];
+    const U bits = (key & sign_bit) ? key & ~sign_bit : ~key;
+    std::memcpy(&first[i], &bits, sizeof(U));
+  }
 }
 
 // this version moves objects within the same buffer
@@ -126,6 +192,33 @@ void kll_helper::randomly_halve_up(T* buf, uint32_t start, uint32_t length) {
 // does not destroy the originals after the move
 template <typename T, typename C>
 void kll_helper::merge_sorted_arrays(T* buf, uint32_t start_a, uint32_t len_a, uint32_t start_b, uint32_t len_b, uint32_t start_c) {
+  merge_sorted_arrays<T, C>(buf, start_a, len_a, start_b, len_b, start_c, std::is_arithmetic<T>());
+}
+
+// the output never overtakes the second input, so each value is read before its slot is written
+template <typename T, typename C>
+void kll_helper::merge_sorted_arrays(T* buf, uint32_t start_a, uint32_t len_a, uint32_t start_b, uint32_t len_b, uint32_t start_c,
+    std::true_type) {
+  const uint32_t lim_a = start_a + len_a;
+  const uint32_t lim_b = start_b + len_b;
+  uint32_t a = start_a;
+  uint32_t b = start_b;
+  uint32_t c = start_c;
+  while (a < lim_a && b < lim_b) {
+    const T value_a = buf[a];
+    const T value_b = buf[b];
+    const bool take_a = C()(value_a, value_b);
+    buf[c++] = take_a ? value_a : value_b;
+    a += take_a;
+    b += !take_a;
+  }
+  while (a < lim_a) buf[c++] = buf[a++];
+  while (b < lim_b) buf[c++] = buf[b++];
+}
+
+template <typename T, typename C>
+void kll_helper::merge_sorted_arrays(T* buf, uint32_t start_a, uint32_t len_a, uint32_t start_b, uint32_t len_b, uint32_t start_c,
+    std::false_type) {
   const uint32_t len_c = len_a + len_b;
   const uint32_t lim_a = start_a + len_a;
   const uint32_t lim_b = start_b + len_b;
@@ -158,6 +251,32 @@ void kll_helper::merge_sorted_arrays(T* buf, uint32_t start_a, uint32_t len_a, u
 // copies objects from buf_b
 template <typename T, typename C>
 void kll_helper::merge_sorted_arrays(const T* buf_a, uint32_t start_a, uint32_t len_a, const T* buf_b, uint32_t start_b, uint32_t len_b, T* buf_c, uint32_t start_c) {
+  merge_sorted_arrays<T, C>(buf_a, start_a, len_a, buf_b, start_b, len_b, buf_c, start_c, std::is_arithmetic<T>());
+}
+
+template <typename T, typename C>
+void kll_helper::merge_sorted_arrays(const T* buf_a, uint32_t start_a, uint32_t len_a, const T* buf_b, uint32_t start_b, uint32_t len_b,
+    T* buf_c, uint32_t start_c, std::true_type) {
+  const uint32_t lim_a = start_a + len_a;
+  const uint32_t lim_b = start_b + len_b;
+  uint32_t a = start_a;
+  uint32_t b = start_b;
+  uint32_t c = start_c;
+  while (a < lim_a && b < lim_b) {
+    const T value_a = buf_a[a];
+    const T value_b = buf_b[b];
+    const bool take_a = C()(value_a, value_b);
+    buf_c[c++] = take_a ? value_a : value_b;
+    a += take_a;
+    b += !take_a;
+  }
+  while (a < lim_a) buf_c[c++] = buf_a[a++];
+  while (b < lim_b) buf_c[c++] = buf_b[b++];
+}
+
+template <typename T, typename C>
+void kll_helper::merge_sorted_arrays(const T* buf_a, uint32_t start_a, uint32_t len_a, const T* buf_b, uint32_t start_b, uint32_t len_b,
+    T* buf_c, uint32_t start_c, std::false_type) {
   const uint32_t len_c = len_a + len_b;
   const uint32_t lim_a = start_a + len_a;
   const uint32_t lim_b = start_b + len_b;
@@ -199,9 +318,10 @@ void kll_helper::merge_sorted_arrays(const T* buf_a, uint32_t start_a, uint32_t
  * sorted afterwards.
  * Level zero is not required to be sorted before, and may not be sorted afterwards.
  */
-template <typename T, typename C>
+template <typename T, typename C, typename A>
 kll_helper::compress_result kll_helper::general_compress(uint16_t k, uint8_t m, uint8_t num_levels_in, T* items,
-        uint32_t* in_levels, uint32_t* out_levels, bool is_level_zero_sorted)
+        uint32_t* in_levels, uint32_t* out_levels, bool is_level_zero_sorted, kll_random_bits& random_bits,
+        const A& allocator)
 {
   if (num_levels_in == 0) throw std::invalid_argument("num_levels_in == 0"); // things are too weird if zero levels are allowed
   const uint32_t starting_item_count = in_levels[num_levels_in] - in_levels[0];
@@ -227,7 +347,10 @@ kll_helper::compress_result kll_helper::general_compress(uint16_t k, uint8_t m,
       // move level over as is
       // make sure we are not moving data upwards
       if (raw_beg < out_levels[current_level]) throw std::logic_error("wrong move");
-      std::move(&items[raw_beg], &items[raw_lim], &items[out_levels[current_level]]);
+      // self-move assignment may leave items such as strings empty
+      if (raw_beg != out_levels[current_level]) {
+        std::move(&items[raw_beg], &items[raw_lim], &items[out_levels[current_level]]);
+      }
       out_levels[current_level + 1] = out_levels[current_level] + raw_pop;
     } else {
       // The sketch is too full AND this level is too full, so we compact it
@@ -248,13 +371,13 @@ kll_helper::compress_result kll_helper::general_compress(uint16_t k, uint8_t m,
 
       // level zero might not be sorted, so we must sort it if we wish to compact it
       if ((current_level == 0) && !is_level_zero_sorted) {
-        std::sort(&items[adj_beg], &items[adj_beg + adj_pop], C());
+        sort_items<T, C>(&items[adj_beg], &items[adj_beg + adj_pop], allocator);
       }
 
       if (pop_above == 0) { // Level above is empty, so halve up
-        randomly_halve_up(items, adj_beg, adj_pop);
+        randomly_halve_up(items, adj_beg, adj_pop, random_bits);
       } else { // Level above is nonempty, so halve down, then merge up
-        randomly_halve_down(items, adj_beg, adj_pop);
+        randomly_halve_down(items, adj_beg, adj_pop, random_bits);
         merge_sorted_arrays<T, C>(items, adj_beg, half_adj_pop, raw_lim, pop_above, adj_beg + half_adj_pop);
       }
 
@@ -21,16 +21,35 @@
 #define KLL_QUANTILE_CALCULATOR_HPP_
 
 #include <memory>
+#include <vector>
 
 namespace datasketches {
 
+/*
+ * All retained items of a sketch merged into one sorted array with cumulative weights.
+ * Once built, it answers quantile, rank, PMF and CDF queries with binary search,
+ * so it is the preferred way to run many queries against the same sketch.
+ * It does not reference the sketch, and is not affected by subsequent updates of the sketch.
+ */
 template <typename T, typename C, typename A>
 class kll_quantile_calculator {
   public:
+    using vector_double = std::vector<double, typename std::allocator_traits<A>::template rebind_alloc<double>>;
+
     // assumes that all levels are sorted including level 0
     kll_quantile_calculator(const T* items, const uint32_t* levels, uint8_t num_levels, uint64_t n, const A& allocator);
     T get_quantile(double fraction) const;
 
+    // normalized rank of the given value: the fraction of the stream that is less than the value
+    double get_rank(const T& value) const;
+
+    // split points must be unique and monotonically increasing, see kll_sketch::get_PMF() and get_CDF()
+    vector_double get_PMF(const T* split_points, uint32_t size) const;
+    vector_double get_CDF(const T* split_points, uint32_t size) const;
+
+    uint64_t get_n() const { return n_; }
+    uint32_t get_num_retained() const { return static_cast<uint32_t>(entries_.size()); }
+
   private:
     using AllocU32 = typename std::allocator_traits<A>::template rebind_alloc<uint32_t>;
     using vector_u32 = std::vector<uint32_t, AllocU32>;
@@ -41,6 +60,8 @@ class kll_quantile_calculator {
     vector_u32 levels_;
     Container entries_;
 
+    uint64_t weight_below(typename Container::const_iterator from, const T& value, typename Container::const_iterator& it) const;
+    vector_double get_PMF_or_CDF(const T* split_points, uint32_t size, bool is_CDF) const;
     void populate_from_sketch(const T* items, const uint32_t* levels, uint8_t num_levels);
     T approximately_answer_positional_query(uint64_t pos) const;
     void convert_to_preceding_cummulative();
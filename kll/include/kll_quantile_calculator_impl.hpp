@@ -45,6 +45,46 @@ T kll_quantile_calculator<T, C, A>::get_quantile(double fraction) const {
   return approximately_answer_positional_query(pos_of_phi(fraction, n_));
 }
 
+template <typename T, typename C, typename A>
+double kll_quantile_calculator<T, C, A>::get_rank(const T& value) const {
+  typename Container::const_iterator it;
+  return static_cast<double>(weight_below(entries_.begin(), value, it)) / n_;
+}
+
+template <typename T, typename C, typename A>
+auto kll_quantile_calculator<T, C, A>::get_PMF(const T* split_points, uint32_t size) const -> vector_double {
+  return get_PMF_or_CDF(split_points, size, false);
+}
+
+template <typename T, typename C, typename A>
+auto kll_quantile_calculator<T, C, A>::get_CDF(const T* split_points, uint32_t size) const -> vector_double {
+  return get_PMF_or_CDF(split_points, size, true);
+}
+
+// total weight of the items less than the given value,
+// searching from the given position, which must not be past the first such item
+template <typename T, typename C, typename A>
+uint64_t kll_quantile_calculator<T, C, A>::weight_below(typename Container::const_iterator from, const T& value,
+    typename Container::const_iterator& it) const {
+  it = std::lower_bound(from, entries_.end(), value, [](const Entry& entry, const T& v) { return C()(entry.first, v); });
+  return it == entries_.end() ? n_ : it->second;
+}
+
+template <typename T, typename C, typename A>
+auto kll_quantile_calculator<T, C, A>::get_PMF_or_CDF(const T* split_points, uint32_t size, bool is_CDF) const -> vector_double {
+  kll_helper::validate_values<T, C>(split_points, size);
+  vector_double buckets(size + 1, 0, entries_.get_allocator());
+  typename Container::const_iterator it = entries_.begin();
+  uint64_t previous = 0;
+  for (uint32_t i = 0; i < size; i++) {
+    const uint64_t weight = weight_below(it, split_points[i], it);
+    buckets[i] = static_cast<double>(is_CDF ? weight : weight - previous) / n_;
+    previous = weight;
+  }
+  buckets[size] = static_cast<double>(is_CDF ? n_ : n_ - previous) / n_;
+  return buckets;
+}
+
 template <typename T, typename C, typename A>
 void kll_quantile_calculator<T, C, A>::populate_from_sketch(const T* items, const uint32_t* levels, uint8_t num_levels) {
   size_t src_level = 0;
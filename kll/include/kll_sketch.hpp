@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "kll_quantile_calculator.hpp"
+#include "kll_helper.hpp"
 #include "common_defs.hpp"
 #include "serde.hpp"
 
@@ -182,6 +183,26 @@ class kll_sketch {
      */
     void update(T&& value);
 
+    /**
+     * Updates this sketch with an array of data items.
+     * Produces exactly the same result as calling update() for each item in order,
+     * but copies items into level zero in bulk, compacting only when it is full,
+     * and updates min and max values once per filled block.
+     * @param items pointer to the array of items
+     * @param size number of items in the array
+     */
+    void update(const T* items, size_t size);
+
+    /**
+     * Updates this sketch with a range of data items.
+     * Produces exactly the same result as calling update() for each item in order.
+     * Use std::make_move_iterator() to move items into the sketch.
+     * @param first beginning of the range
+     * @param last end of the range
+     */
+    template<typename InputIt>
+    void update(InputIt first, InputIt last);
+
     /**
      * Merges another sketch into this one.
      * This method takes lvalue.
@@ -196,6 +217,58 @@ class kll_sketch {
      */
     void merge(kll_sketch&& other);
 
+    /**
+     * Merges a serialized sketch into this one without deserializing it first.
+     * For arithmetic types with the default serde the retained items are read directly
+     * from the given bytes, so no intermediate sketch is constructed. For other types
+     * this is equivalent to merging the result of deserialize().
+     * @param bytes pointer to the array of bytes produced by serialize()
+     * @param size the size of the array
+     */
+    void merge_serialized(const void* bytes, size_t size);
+
+    /**
+     * Merges a serialized sketch into this one using a given instance of serde.
+     * Items that are not read directly from the given bytes are deserialized with it,
+     * for instance with a given allocator.
+     * @param bytes pointer to the array of bytes produced by serialize()
+     * @param size the size of the array
+     * @param sd instance of serde to deserialize items with
+     */
+    void merge_serialized(const void* bytes, size_t size, const S& sd);
+
+    /**
+     * Merges many sketches using multiple threads.
+     * The inputs are split into contiguous blocks, one per thread. Each thread merges its block
+     * into a single sketch, and the results of the blocks are merged pairwise in a balanced tree.
+     * The result is statistically equivalent to merging the sketches one by one into a single sketch.
+     * Each block is merged into a new empty sketch with parameter k of the first input.
+     * If the range is given with std::make_move_iterator(), the inputs are merged with the move overload.
+     * The result has parameter k of the first sketch.
+     * If the range is empty, returns an empty sketch with default k.
+     * The allocator of the first sketch is used on all threads, so it must be thread safe.
+     * In particular, sketches with an arena_allocator must be merged on one thread.
+     * Requires linking with a thread library.
+     * @param first random access iterator to the first sketch
+     * @param last random access iterator past the last sketch
+     * @param num_threads maximum number of threads to use, must be positive
+     * @return the result of the merge
+     */
+    template<typename RandomIt>
+    static kll_sketch merge_all(RandomIt first, RandomIt last, unsigned num_threads);
+
+    /**
+     * Seeds the source of random bits used by this sketch for compaction.
+     * Two sketches seeded identically produce identical results for identical input.
+     * Unseeded sketches draw their seeds from a per-thread sequence, so independent
+     * sketches can be updated concurrently from different threads.
+     * A copy of a seeded sketch draws the same sequence of random bits as its original.
+     * A copy of an unseeded sketch takes a new seed from the per-thread sequence.
+     * The random state is not serialized.
+     * @param seed the seed
+     */
+    void set_random_seed(uint64_t seed);
+
     /**
      * Returns true if this sketch is empty.
      * @return empty flag
@@ -249,7 +322,7 @@ class kll_sketch {
      * <p>
      * Note that this method has a fairly large overhead (microseconds instead of nanoseconds)
      * so it should not be called multiple times to get different quantiles from the same
-     * sketch. Instead use get_quantiles(), which pays the overhead only once.
+     * sketch. Instead use get_quantiles() or get_sorted_view(), which pay the overhead only once.
      * <p>
      * For floating point types: if the sketch is empty this returns NaN.
      * For other types: if the sketch is empty this throws runtime_error.
@@ -312,6 +385,20 @@ class kll_sketch {
      */
     double get_rank(const T& value) const;
 
+    /**
+     * Returns approximations to the normalized ranks of the given values, in the order of the values.
+     * Each rank is the same as get_rank() would return for the value, but the values are sorted once
+     * and every level of the sketch is scanned once for all of them.
+     * The values do not need to be sorted or unique.
+     *
+     * <p>If the sketch is empty this returns NaN for every value.
+     *
+     * @param values an array of values to be ranked
+     * @param size the number of values
+     * @return an array of approximate ranks of the given values
+     */
+    vector_d<A> get_ranks(const T* values, uint32_t size) const;
+
     /**
      * Returns an approximation to the Probability Mass Function (PMF) of the input stream
      * given a set of split points (values).
@@ -358,6 +445,22 @@ class kll_sketch {
      */
     vector_d<A> get_CDF(const T* split_points, uint32_t size) const;
 
+    using sorted_view = kll_quantile_calculator<T, C, A>;
+
+    /**
+     * Returns a sorted view of this sketch: all retained items merged into one sorted array
+     * with cumulative weights. The view answers get_quantile(), get_rank(), get_PMF() and get_CDF()
+     * with binary search, so it should be used when many queries are issued against the same sketch.
+     * The view is a snapshot, it does not reflect subsequent updates or merges of the sketch.
+     * Unlike the sketch, the view returns the smallest and largest retained items
+     * for fractions 0 and 1 rather than the true min and max values.
+     *
+     * <p>If the sketch is empty this throws runtime_error.
+     *
+     * @return sorted view of this sketch
+     */
+    sorted_view get_sorted_view() const;
+
     /**
      * Gets the approximate rank error of this sketch normalized as a fraction between zero and one.
      * @param pmf if true, returns the "double-sided" normalized rank error for the get_PMF() function.
@@ -409,6 +512,14 @@ class kll_sketch {
      */
     static kll_sketch<T, C, S, A> deserialize(std::istream& is, const A& allocator = A());
 
+    /**
+     * This method deserializes a sketch from a given stream using a given instance of serde.
+     * @param is input stream
+     * @param sd instance of serde to deserialize items with, for instance with a given allocator
+     * @return an instance of a sketch
+     */
+    static kll_sketch<T, C, S, A> deserialize(std::istream& is, const S& sd, const A& allocator = A());
+
     /**
      * This method deserializes a sketch from a given array of bytes.
      * @param bytes pointer to the array of bytes
@@ -417,6 +528,15 @@ class kll_sketch {
      */
     static kll_sketch<T, C, S, A> deserialize(const void* bytes, size_t size, const A& allocator = A());
 
+    /**
+     * This method deserializes a sketch from a given array of bytes using a given instance of serde.
+     * @param bytes pointer to the array of bytes
+     * @param size the size of the array
+     * @param sd instance of serde to deserialize items with, for instance with a given allocator
+     * @return an instance of a sketch
+     */
+    static kll_sketch<T, C, S, A> deserialize(const void* bytes, size_t size, const S& sd, const A& allocator = A());
+
     /*
      * Gets the normalized rank error given k and pmf.
      * k - the configuration parameter
@@ -479,6 +599,7 @@ class kll_sketch {
     T* min_value_;
     T* max_value_;
     bool is_level_zero_sorted_;
+    kll_random_bits random_bits_;
 
     // for deserialization
     class item_deleter;
@@ -487,8 +608,39 @@ class kll_sketch {
         std::unique_ptr<T, items_deleter> items, uint32_t items_size, std::unique_ptr<T, item_deleter> min_value,
         std::unique_ptr<T, item_deleter> max_value, bool is_level_zero_sorted);
 
+    template<typename RandomIt>
+    static kll_sketch merge_block(RandomIt first, RandomIt last);
+
+    // levels of a serialized sketch merged in place
+    struct levels_view {
+      const T* items_;
+      const uint32_t* levels_;
+      uint8_t num_levels_;
+      uint32_t safe_level_size(uint8_t level) const;
+      uint32_t get_num_retained_above_level_zero() const;
+    };
+    void merge_serialized(const void* bytes, size_t size, const S& sd, std::true_type);
+    void merge_serialized(const void* bytes, size_t size, const S& sd, std::false_type);
+
+    // checked preamble of a serialized sketch, followed by min and max values and items at data
+    struct serialized_header {
+      uint16_t k;
+      uint8_t m;
+      bool is_empty;
+      bool is_single_item;
+      bool is_level_zero_sorted;
+      uint64_t n;
+      uint16_t min_k;
+      uint8_t num_levels;
+      const char* data;
+    };
+    // fills in the levels unless the sketch is empty
+    static serialized_header read_header(const void* bytes, size_t size, vector_u32<A>& levels);
+
     // common update code
     inline void update_min_max(const T& value);
+    inline void update_min_max(const T* items, uint32_t size);
+    void finish_batch_update(uint32_t begin, uint32_t end);
     inline uint32_t internal_update();
 
     // The following code is only valid in the special case of exactly reaching capacity while updating.
@@ -505,7 +657,8 @@ class kll_sketch {
     void increment_buckets_sorted_level(uint32_t from_index, uint32_t to_index, uint64_t weight,
         const T* split_points, uint32_t size, double* buckets) const;
     template<typename O> void merge_higher_levels(O&& other, uint64_t final_n);
-    void populate_work_arrays(const kll_sketch& other, T* workbuf, uint32_t* worklevels, uint8_t provisional_num_levels);
+    template<typename O>
+    void populate_work_arrays(const O& other, T* workbuf, uint32_t* worklevels, uint8_t provisional_num_levels);
     void populate_work_arrays(kll_sketch&& other, T* workbuf, uint32_t* worklevels, uint8_t provisional_num_levels);
     void assert_correct_total_weight() const;
     uint32_t safe_level_size(uint8_t level) const;
@@ -534,7 +687,7 @@ class kll_sketch {
     }
 
     template<typename TT = T, typename std::enable_if<!std::is_floating_point<TT>::value, int>::type = 0>
-    static inline bool check_update_value(TT) {
+    static inline bool check_update_value(const TT&) {
       return true;
     }
 
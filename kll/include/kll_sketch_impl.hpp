@@ -25,6 +25,7 @@
 #include <sstream>
 
 #include "memory_operations.hpp"
+#include "run_threads.hpp"
 #include "kll_helper.hpp"
 
 namespace datasketches {
@@ -64,7 +65,8 @@ items_(nullptr),
 items_size_(other.items_size_),
 min_value_(nullptr),
 max_value_(nullptr),
-is_level_zero_sorted_(other.is_level_zero_sorted_)
+is_level_zero_sorted_(other.is_level_zero_sorted_),
+random_bits_(other.random_bits_)
 {
   items_ = allocator_.allocate(items_size_);
   std::copy(&other.items_[levels_[0]], &other.items_[levels_[num_levels_]], &items_[levels_[0]]);
@@ -85,7 +87,8 @@ items_(other.items_),
 items_size_(other.items_size_),
 min_value_(other.min_value_),
 max_value_(other.max_value_),
-is_level_zero_sorted_(other.is_level_zero_sorted_)
+is_level_zero_sorted_(other.is_level_zero_sorted_),
+random_bits_(std::move(other.random_bits_))
 {
   other.items_ = nullptr;
   other.min_value_ = nullptr;
@@ -107,6 +110,7 @@ kll_sketch<T, C, S, A>& kll_sketch<T, C, S, A>::operator=(const kll_sketch& othe
   std::swap(min_value_, copy.min_value_);
   std::swap(max_value_, copy.max_value_);
   std::swap(is_level_zero_sorted_, copy.is_level_zero_sorted_);
+  std::swap(random_bits_, copy.random_bits_);
   return *this;
 }
 
@@ -124,6 +128,7 @@ kll_sketch<T, C, S, A>& kll_sketch<T, C, S, A>::operator=(kll_sketch&& other) {
   std::swap(min_value_, other.min_value_);
   std::swap(max_value_, other.max_value_);
   std::swap(is_level_zero_sorted_, other.is_level_zero_sorted_);
+  std::swap(random_bits_, other.random_bits_);
   return *this;
 }
 
@@ -161,6 +166,58 @@ void kll_sketch<T, C, S, A>::update(T&& value) {
   new (&items_[index]) T(std::move(value));
 }
 
+template<typename T, typename C, typename S, typename A>
+void kll_sketch<T, C, S, A>::update(const T* items, size_t size) {
+  update(items, items + size);
+}
+
+template<typename T, typename C, typename S, typename A>
+template<typename InputIt>
+void kll_sketch<T, C, S, A>::update(InputIt first, InputIt last) {
+  // items go into the same slots of level zero as with update() one at a time,
+  // so that compaction sees exactly the same layout
+  uint32_t index = levels_[0];
+  uint32_t end = index;
+  for (; first != last; ++first) {
+    auto&& item = *first;
+    if (!check_update_value(item)) continue;
+    if (index == 0) {
+      finish_batch_update(index, end);
+      compress_while_updating();
+      index = end = levels_[0];
+    }
+    new (&items_[--index]) T(std::forward<decltype(item)>(item));
+  }
+  finish_batch_update(index, end);
+}
+
+// accounts for items placed in level zero at [begin, end) by a batch update
+template<typename T, typename C, typename S, typename A>
+void kll_sketch<T, C, S, A>::finish_batch_update(uint32_t begin, uint32_t end) {
+  if (begin == end) return;
+  update_min_max(&items_[begin], end - begin);
+  levels_[0] = begin;
+  n_ += end - begin;
+  is_level_zero_sorted_ = false;
+}
+
+template<typename T, typename C, typename S, typename A>
+void kll_sketch<T, C, S, A>::update_min_max(const T* items, uint32_t size) {
+  uint32_t min_index = 0;
+  uint32_t max_index = 0;
+  for (uint32_t i = 1; i < size; i++) {
+    if (C()(items[i], items[min_index])) min_index = i;
+    if (C()(items[max_index], items[i])) max_index = i;
+  }
+  if (is_empty()) {
+    min_value_ = new (allocator_.allocate(1)) T(items[min_index]);
+    max_value_ = new (allocator_.allocate(1)) T(items[max_index]);
+  } else {
+    if (C()(items[min_index], *min_value_)) *min_value_ = items[min_index];
+    if (C()(*max_value_, items[max_index])) *max_value_ = items[max_index];
+  }
+}
+
 template<typename T, typename C, typename S, typename A>
 void kll_sketch<T, C, S, A>::update_min_max(const T& value) {
   if (is_empty()) {
@@ -228,6 +285,127 @@ void kll_sketch<T, C, S, A>::merge(kll_sketch&& other) {
   assert_correct_total_weight();
 }
 
+template<typename T, typename C, typename S, typename A>
+void kll_sketch<T, C, S, A>::merge_serialized(const void* bytes, size_t size) {
+  merge_serialized(bytes, size, S());
+}
+
+template<typename T, typename C, typename S, typename A>
+void kll_sketch<T, C, S, A>::merge_serialized(const void* bytes, size_t size, const S& sd) {
+  merge_serialized(bytes, size, sd, std::integral_constant<bool,
+      std::is_arithmetic<T>::value && std::is_same<S, serde<T>>::value>());
+}
+
+// generic version: items need the serde to be read
+template<typename T, typename C, typename S, typename A>
+void kll_sketch<T, C, S, A>::merge_serialized(const void* bytes, size_t size, const S& sd, std::false_type) {
+  merge(deserialize(bytes, size, sd, allocator_));
+}
+
+// items of arithmetic types are stored as is, so the levels are merged directly from the bytes
+template<typename T, typename C, typename S, typename A>
+void kll_sketch<T, C, S, A>::merge_serialized(const void* bytes, size_t size, const S&, std::true_type) {
+  vector_u32<A> levels(allocator_);
+  const serialized_header header = read_header(bytes, size, levels);
+  if (header.is_empty) return;
+  if (m_ != header.m) {
+    throw std::invalid_argument("incompatible M: " + std::to_string(m_) + " and " + std::to_string(header.m));
+  }
+  const char* ptr = header.data;
+
+  if (header.is_single_item) {
+    const size_t expected_size = DATA_START_SINGLE_ITEM + sizeof(T);
+    ensure_minimum_memory(size, expected_size);
+    if (size != expected_size) throw std::logic_error("deserialized size mismatch: " + std::to_string(expected_size) + " != " + std::to_string(size));
+    T item;
+    copy_from_mem(ptr, &item, sizeof(T));
+    update(item);
+    return;
+  }
+
+  const uint8_t num_levels = header.num_levels;
+  const uint32_t num_items = levels[num_levels] - levels[0];
+  const size_t expected_size = DATA_START + sizeof(uint32_t) * num_levels + sizeof(T) * (2 + num_items);
+  ensure_minimum_memory(size, expected_size);
+  if (size != expected_size) throw std::logic_error("deserialized size mismatch: " + std::to_string(expected_size) + " != " + std::to_string(size));
+  T min_value;
+  ptr += copy_from_mem(ptr, &min_value, sizeof(T));
+  T max_value;
+  ptr += copy_from_mem(ptr, &max_value, sizeof(T));
+
+  // items are used in place if the bytes happen to be suitably aligned for T
+  std::vector<T, A> items_copy(allocator_);
+  const T* items = reinterpret_cast<const T*>(ptr);
+  if (reinterpret_cast<uintptr_t>(ptr) % alignof(T) != 0) {
+    items_copy.resize(num_items);
+    copy_from_mem(ptr, items_copy.data(), sizeof(T) * num_items);
+    items = items_copy.data();
+  }
+  const uint32_t offset = levels[0];
+  for (uint8_t lvl = 0; lvl <= num_levels; lvl++) levels[lvl] -= offset;
+  const levels_view other{items, levels.data(), num_levels};
+
+  if (this->is_empty()) {
+    min_value_ = new (allocator_.allocate(1)) T(min_value);
+    max_value_ = new (allocator_.allocate(1)) T(max_value);
+  } else {
+    if (C()(min_value, *min_value_)) *min_value_ = min_value;
+    if (C()(*max_value_, max_value)) *max_value_ = max_value;
+  }
+  const uint64_t final_n = n_ + header.n;
+  for (uint32_t i = other.levels_[0]; i < other.levels_[1]; i++) {
+    const uint32_t index = internal_update();
+    new (&items_[index]) T(other.items_[i]);
+  }
+  if (other.num_levels_ >= 2) merge_higher_levels(other, final_n);
+  n_ = final_n;
+  if (num_levels > 1) min_k_ = std::min(min_k_, header.min_k);
+  assert_correct_total_weight();
+}
+
+template<typename T, typename C, typename S, typename A>
+template<typename RandomIt>
+kll_sketch<T, C, S, A> kll_sketch<T, C, S, A>::merge_all(RandomIt first, RandomIt last, unsigned num_threads) {
+  if (num_threads == 0) throw std::invalid_argument("number of threads must be positive");
+  const size_t num_sketches = std::distance(first, last);
+  if (num_sketches == 0) return kll_sketch();
+  num_threads = static_cast<unsigned>(std::min<size_t>(num_threads, num_sketches));
+  if (num_threads == 1) return merge_block(first, last);
+
+  // placeholders, replaced by the results of the blocks
+  std::vector<kll_sketch> partials(num_threads, kll_sketch(MIN_K));
+  run_threads(num_threads, [&](unsigned t) {
+    const size_t start = num_sketches * t / num_threads;
+    const size_t end = num_sketches * (t + 1) / num_threads;
+    partials[t] = merge_block(first + start, first + end);
+  });
+
+  for (unsigned step = 1; step < num_threads; step *= 2) {
+    const unsigned num_merges = (num_threads - step + 2 * step - 1) / (2 * step);
+    run_threads(num_merges, [&](unsigned m) {
+      const unsigned i = m * 2 * step;
+      partials[i].merge(std::move(partials[i + step]));
+    });
+  }
+  return std::move(partials[0]);
+}
+
+// merges a non-empty range of sketches into a new sketch with the k of the first one
+// and a random state of its own, so that its compactions do not replay those of any input
+template<typename T, typename C, typename S, typename A>
+template<typename RandomIt>
+kll_sketch<T, C, S, A> kll_sketch<T, C, S, A>::merge_block(RandomIt first, RandomIt last) {
+  const kll_sketch& front = *first;
+  kll_sketch result(front.get_k(), front.allocator_);
+  for (; first != last; ++first) result.merge(*first);
+  return result;
+}
+
+template<typename T, typename C, typename S, typename A>
+void kll_sketch<T, C, S, A>::set_random_seed(uint64_t seed) {
+  random_bits_.seed(seed);
+}
+
 template<typename T, typename C, typename S, typename A>
 bool kll_sketch<T, C, S, A>::is_empty() const {
   return n_ == 0;
@@ -341,6 +519,38 @@ double kll_sketch<T, C, S, A>::get_rank(const T& value) const {
   return (double) total / n_;
 }
 
+template<typename T, typename C, typename S, typename A>
+vector_d<A> kll_sketch<T, C, S, A>::get_ranks(const T* values, uint32_t size) const {
+  if (is_empty()) return vector_d<A>(size, std::numeric_limits<double>::quiet_NaN(), allocator_);
+  vector_d<A> ranks(size, 0, allocator_);
+  // indices of the values in sorted order, values that cannot be ordered (NaN) are ranked one by one
+  vector_u32<A> order(allocator_);
+  order.reserve(size);
+  for (uint32_t i = 0; i < size; i++) {
+    if (check_update_value(values[i])) {
+      order.push_back(i);
+    } else {
+      ranks[i] = get_rank(values[i]);
+    }
+  }
+  std::sort(order.begin(), order.end(), [values](uint32_t a, uint32_t b) { return C()(values[a], values[b]); });
+  // has side effect of sorting level zero if needed
+  const_cast<kll_sketch*>(this)->sort_level_zero();
+  uint64_t weight = 1;
+  for (uint8_t level = 0; level < num_levels_; level++) {
+    const uint32_t from_index = levels_[level];
+    const uint32_t to_index = levels_[level + 1]; // exclusive
+    uint32_t index = from_index;
+    for (uint32_t i: order) {
+      while (index < to_index && C()(items_[index], values[i])) index++;
+      ranks[i] += static_cast<double>(weight * (index - from_index));
+    }
+    weight *= 2;
+  }
+  for (uint32_t i: order) ranks[i] /= n_;
+  return ranks;
+}
+
 template<typename T, typename C, typename S, typename A>
 vector_d<A> kll_sketch<T, C, S, A>::get_PMF(const T* split_points, uint32_t size) const {
   return get_PMF_or_CDF(split_points, size, false);
@@ -351,6 +561,14 @@ vector_d<A> kll_sketch<T, C, S, A>::get_CDF(const T* split_points, uint32_t size
   return get_PMF_or_CDF(split_points, size, true);
 }
 
+template<typename T, typename C, typename S, typename A>
+auto kll_sketch<T, C, S, A>::get_sorted_view() const -> sorted_view {
+  if (is_empty()) throw std::runtime_error("sorted view of an empty sketch is not supported");
+  // has side effect of sorting level zero if needed
+  const_cast<kll_sketch*>(this)->sort_level_zero();
+  return sorted_view(items_, levels_.data(), num_levels_, n_, allocator_);
+}
+
 template<typename T, typename C, typename S, typename A>
 double kll_sketch<T, C, S, A>::get_normalized_rank_error(bool pmf) const {
   return get_normalized_rank_error(min_k_, pmf);
@@ -459,6 +677,11 @@ vector_u8<A> kll_sketch<T, C, S, A>::serialize(unsigned header_size_bytes) const
 
 template<typename T, typename C, typename S, typename A>
 kll_sketch<T, C, S, A> kll_sketch<T, C, S, A>::deserialize(std::istream& is, const A& allocator) {
+  return deserialize(is, S(), allocator);
+}
+
+template<typename T, typename C, typename S, typename A>
+kll_sketch<T, C, S, A> kll_sketch<T, C, S, A>::deserialize(std::istream& is, const S& sd, const A& allocator) {
   uint8_t preamble_ints;
   is.read((char*)&preamble_ints, sizeof(preamble_ints));
   uint8_t serial_version;
@@ -513,17 +736,17 @@ kll_sketch<T, C, S, A> kll_sketch<T, C, S, A>::deserialize(std::istream& is, con
   std::unique_ptr<T, item_deleter> min_value(nullptr, item_deleter(allocator));
   std::unique_ptr<T, item_deleter> max_value(nullptr, item_deleter(allocator));
   if (!is_single_item) {
-    S().deserialize(is, min_value_buffer.get(), 1);
+    sd.deserialize(is, min_value_buffer.get(), 1);
     // serde call did not throw, repackage with destrtuctor
     min_value = std::unique_ptr<T, item_deleter>(min_value_buffer.release(), item_deleter(allocator));
-    S().deserialize(is, max_value_buffer.get(), 1);
+    sd.deserialize(is, max_value_buffer.get(), 1);
     // serde call did not throw, repackage with destrtuctor
     max_value = std::unique_ptr<T, item_deleter>(max_value_buffer.release(), item_deleter(allocator));
   }
   auto items_buffer_deleter = [capacity, &alloc](T* ptr) { alloc.deallocate(ptr, capacity); };
   std::unique_ptr<T, decltype(items_buffer_deleter)> items_buffer(alloc.allocate(capacity), items_buffer_deleter);
   const auto num_items = levels[num_levels] - levels[0];
-  S().deserialize(is, &items_buffer.get()[levels[0]], num_items);
+  sd.deserialize(is, &items_buffer.get()[levels[0]], num_items);
   // serde call did not throw, repackage with destrtuctors
   std::unique_ptr<T, items_deleter> items(items_buffer.release(), items_deleter(levels[0], capacity, allocator));
   const bool is_level_zero_sorted = (flags_byte & (1 << flags::IS_LEVEL_ZERO_SORTED)) > 0;
@@ -543,6 +766,57 @@ kll_sketch<T, C, S, A> kll_sketch<T, C, S, A>::deserialize(std::istream& is, con
 
 template<typename T, typename C, typename S, typename A>
 kll_sketch<T, C, S, A> kll_sketch<T, C, S, A>::deserialize(const void* bytes, size_t size, const A& allocator) {
+  return deserialize(bytes, size, S(), allocator);
+}
+
+template<typename T, typename C, typename S, typename A>
+kll_sketch<T, C, S, A> kll_sketch<T, C, S, A>::deserialize(const void* bytes, size_t size, const S& sd,
+    const A& allocator) {
+  vector_u32<A> levels(allocator);
+  const serialized_header header = read_header(bytes, size, levels);
+  if (header.is_empty) return kll_sketch<T, C, S, A>(header.k, allocator);
+  const char* ptr = header.data;
+  const char* end_ptr = static_cast<const char*>(bytes) + size;
+  const bool is_single_item = header.is_single_item;
+  const uint8_t num_levels = header.num_levels;
+  const uint32_t capacity = levels[num_levels];
+  A alloc(allocator);
+  auto item_buffer_deleter = [&alloc](T* ptr) { alloc.deallocate(ptr, 1); };
+  std::unique_ptr<T, decltype(item_buffer_deleter)> min_value_buffer(alloc.allocate(1), item_buffer_deleter);
+  std::unique_ptr<T, decltype(item_buffer_deleter)> max_value_buffer(alloc.allocate(1), item_buffer_deleter);
+  std::unique_ptr<T, item_deleter> min_value(nullptr, item_deleter(allocator));
+  std::unique_ptr<T, item_deleter> max_value(nullptr, item_deleter(allocator));
+  if (!is_single_item) {
+    ptr += sd.deserialize(ptr, end_ptr - ptr, min_value_buffer.get(), 1);
+    // serde call did not throw, repackage with destrtuctor
+    min_value = std::unique_ptr<T, item_deleter>(min_value_buffer.release(), item_deleter(allocator));
+    ptr += sd.deserialize(ptr, end_ptr - ptr, max_value_buffer.get(), 1);
+    // serde call did not throw, repackage with destrtuctor
+    max_value = std::unique_ptr<T, item_deleter>(max_value_buffer.release(), item_deleter(allocator));
+  }
+  auto items_buffer_deleter = [capacity, &alloc](T* ptr) { alloc.deallocate(ptr, capacity); };
+  std::unique_ptr<T, decltype(items_buffer_deleter)> items_buffer(alloc.allocate(capacity), items_buffer_deleter);
+  const auto num_items = levels[num_levels] - levels[0];
+  ptr += sd.deserialize(ptr, end_ptr - ptr, &items_buffer.get()[levels[0]], num_items);
+  // serde call did not throw, repackage with destrtuctors
+  std::unique_ptr<T, items_deleter> items(items_buffer.release(), items_deleter(levels[0], capacity, allocator));
+  const size_t delta = ptr - static_cast<const char*>(bytes);
+  if (delta != size) throw std::logic_error("deserialized size mismatch: " + std::to_string(delta) + " != " + std::to_string(size));
+  if (is_single_item) {
+    new (min_value_buffer.get()) T(items.get()[levels[0]]);
+    // copy did not throw, repackage with destrtuctor
+    min_value = std::unique_ptr<T, item_deleter>(min_value_buffer.release(), item_deleter(allocator));
+    new (max_value_buffer.get()) T(items.get()[levels[0]]);
+    // copy did not throw, repackage with destrtuctor
+    max_value = std::unique_ptr<T, item_deleter>(max_value_buffer.release(), item_deleter(allocator));
+  }
+  return kll_sketch(header.k, header.min_k, header.n, num_levels, std::move(levels), std::move(items), capacity,
+      std::move(min_value), std::move(max_value), header.is_level_zero_sorted);
+}
+
+// shared by deserialize() and merge_serialized()
+template<typename T, typename C, typename S, typename A>
+auto kll_sketch<T, C, S, A>::read_header(const void* bytes, size_t size, vector_u32<A>& levels) -> serialized_header {
   ensure_minimum_memory(size, 8);
   const char* ptr = static_cast<const char*>(bytes);
   uint8_t preamble_ints;
@@ -565,66 +839,43 @@ kll_sketch<T, C, S, A> kll_sketch<T, C, S, A>::deserialize(const void* bytes, si
   check_family_id(family_id);
   ensure_minimum_memory(size, 1 << preamble_ints);
 
-  const bool is_empty(flags_byte & (1 << flags::IS_EMPTY));
-  if (is_empty) return kll_sketch<T, C, S, A>(k, allocator);
+  serialized_header header;
+  header.k = k;
+  header.m = m;
+  header.is_empty = flags_byte & (1 << flags::IS_EMPTY);
+  header.is_single_item = flags_byte & (1 << flags::IS_SINGLE_ITEM); // used in serial version 2
+  header.is_level_zero_sorted = flags_byte & (1 << flags::IS_LEVEL_ZERO_SORTED);
+  if (header.is_empty) {
+    header.n = 0;
+    header.min_k = k;
+    header.num_levels = 0;
+    header.data = ptr;
+    return header;
+  }
 
-  uint64_t n;
-  uint16_t min_k;
-  uint8_t num_levels;
-  const bool is_single_item(flags_byte & (1 << flags::IS_SINGLE_ITEM)); // used in serial version 2
-  const char* end_ptr = static_cast<const char*>(bytes) + size;
-  if (is_single_item) {
-    n = 1;
-    min_k = k;
-    num_levels = 1;
+  if (header.is_single_item) {
+    header.n = 1;
+    header.min_k = k;
+    header.num_levels = 1;
   } else {
-    ptr += copy_from_mem(ptr, &n, sizeof(n));
-    ptr += copy_from_mem(ptr, &min_k, sizeof(min_k));
-    ptr += copy_from_mem(ptr, &num_levels, sizeof(num_levels));
+    ptr += copy_from_mem(ptr, &header.n, sizeof(header.n));
+    ptr += copy_from_mem(ptr, &header.min_k, sizeof(header.min_k));
+    ptr += copy_from_mem(ptr, &header.num_levels, sizeof(header.num_levels));
     ptr++; // skip unused byte
   }
-  vector_u32<A> levels(num_levels + 1, 0, allocator);
-  const uint32_t capacity(kll_helper::compute_total_capacity(k, m, num_levels));
-  if (is_single_item) {
+  levels.assign(header.num_levels + 1, 0);
+  const uint32_t capacity = kll_helper::compute_total_capacity(k, m, header.num_levels);
+  if (header.is_single_item) {
     levels[0] = capacity - 1;
   } else {
+    ensure_minimum_memory(size, DATA_START + sizeof(uint32_t) * header.num_levels);
     // the last integer in levels_ is not serialized because it can be derived
-    ptr += copy_from_mem(ptr, levels.data(), sizeof(levels[0]) * num_levels);
-  }
-  levels[num_levels] = capacity;
-  A alloc(allocator);
-  auto item_buffer_deleter = [&alloc](T* ptr) { alloc.deallocate(ptr, 1); };
-  std::unique_ptr<T, decltype(item_buffer_deleter)> min_value_buffer(alloc.allocate(1), item_buffer_deleter);
-  std::unique_ptr<T, decltype(item_buffer_deleter)> max_value_buffer(alloc.allocate(1), item_buffer_deleter);
-  std::unique_ptr<T, item_deleter> min_value(nullptr, item_deleter(allocator));
-  std::unique_ptr<T, item_deleter> max_value(nullptr, item_deleter(allocator));
-  if (!is_single_item) {
-    ptr += S().deserialize(ptr, end_ptr - ptr, min_value_buffer.get(), 1);
-    // serde call did not throw, repackage with destrtuctor
-    min_value = std::unique_ptr<T, item_deleter>(min_value_buffer.release(), item_deleter(allocator));
-    ptr += S().deserialize(ptr, end_ptr - ptr, max_value_buffer.get(), 1);
-    // serde call did not throw, repackage with destrtuctor
-    max_value = std::unique_ptr<T, item_deleter>(max_value_buffer.release(), item_deleter(allocator));
-  }
-  auto items_buffer_deleter = [capacity, &alloc](T* ptr) { alloc.deallocate(ptr, capacity); };
-  std::unique_ptr<T, decltype(items_buffer_deleter)> items_buffer(alloc.allocate(capacity), items_buffer_deleter);
-  const auto num_items = levels[num_levels] - levels[0];
-  ptr += S().deserialize(ptr, end_ptr - ptr, &items_buffer.get()[levels[0]], num_items);
-  // serde call did not throw, repackage with destrtuctors
-  std::unique_ptr<T, items_deleter> items(items_buffer.release(), items_deleter(levels[0], capacity, allocator));
-  const size_t delta = ptr - static_cast<const char*>(bytes);
-  if (delta != size) throw std::logic_error("deserialized size mismatch: " + std::to_string(delta) + " != " + std::to_string(size));
-  const bool is_level_zero_sorted = (flags_byte & (1 << flags::IS_LEVEL_ZERO_SORTED)) > 0;
-  if (is_single_item) {
-    new (min_value_buffer.get()) T(items.get()[levels[0]]);
-    // copy did not throw, repackage with destrtuctor
-    min_value = std::unique_ptr<T, item_deleter>(min_value_buffer.release(), item_deleter(allocator));
-    new (max_value_buffer.get()) T(items.get()[levels[0]]);
-    // copy did not throw, repackage with destrtuctor
-    max_value = std::unique_ptr<T, item_deleter>(max_value_buffer.release(), item_deleter(allocator));
+    ptr += copy_from_mem(ptr, levels.data(), sizeof(levels[0]) * header.num_levels);
   }
-  return kll_sketch(k, min_k, n, num_levels, std::move(levels), std::move(items), capacity,
-      std::move(min_value), std::move(max_value), is_level_zero_sorted);
+  levels[header.num_levels] = capacity;
+  if (levels[0] > capacity) throw std::invalid_argument("Possible corruption: invalid levels");
+  header.data = ptr;
+  return header;
 }
 
 /*
@@ -687,12 +938,12 @@ void kll_sketch<T, C, S, A>::compress_while_updating(void) {
   // level zero might not be sorted, so we must sort it if we wish to compact it
   // sort_level_zero() is not used here because of the adjustment for odd number of items
   if ((level == 0) && !is_level_zero_sorted_) {
-    std::sort(&items_[adj_beg], &items_[adj_beg + adj_pop], C());
+    kll_helper::sort_items<T, C>(&items_[adj_beg], &items_[adj_beg + adj_pop], allocator_);
   }
   if (pop_above == 0) {
-    kll_helper::randomly_halve_up(items_, adj_beg, adj_pop);
+    kll_helper::randomly_halve_up(items_, adj_beg, adj_pop, random_bits_);
   } else {
-    kll_helper::randomly_halve_down(items_, adj_beg, adj_pop);
+    kll_helper::randomly_halve_down(items_, adj_beg, adj_pop, random_bits_);
     kll_helper::merge_sorted_arrays<T, C>(items_, adj_beg, half_adj_pop, raw_lim, pop_above, adj_beg + half_adj_pop);
   }
   levels_[level + 1] -= half_adj_pop; // adjust boundaries of the level above
@@ -768,7 +1019,7 @@ void kll_sketch<T, C, S, A>::add_empty_top_level_to_completely_full_sketch() {
 template<typename T, typename C, typename S, typename A>
 void kll_sketch<T, C, S, A>::sort_level_zero() {
   if (!is_level_zero_sorted_) {
-    std::sort(&items_[levels_[0]], &items_[levels_[1]], C());
+    kll_helper::sort_items<T, C>(&items_[levels_[0]], &items_[levels_[1]], allocator_);
     is_level_zero_sorted_ = true;
   }
 }
@@ -780,7 +1031,7 @@ std::unique_ptr<kll_quantile_calculator<T, C, A>, std::function<void(kll_quantil
   AllocCalc alloc(allocator_);
   std::unique_ptr<kll_quantile_calculator<T, C, A>, std::function<void(kll_quantile_calculator<T, C, A>*)>> quantile_calculator(
     new (alloc.allocate(1)) kll_quantile_calculator<T, C, A>(items_, levels_.data(), num_levels_, n_, allocator_),
-    [&alloc](kll_quantile_calculator<T, C, A>* ptr){ ptr->~kll_quantile_calculator<T, C, A>(); alloc.deallocate(ptr, 1); }
+    [alloc](kll_quantile_calculator<T, C, A>* ptr) mutable { ptr->~kll_quantile_calculator<T, C, A>(); alloc.deallocate(ptr, 1); }
   );
   return quantile_calculator;
 }
@@ -872,7 +1123,7 @@ void kll_sketch<T, C, S, A>::merge_higher_levels(O&& other, uint64_t final_n) {
   populate_work_arrays(std::forward<O>(other), workbuf.get(), worklevels.data(), provisional_num_levels);
 
   const kll_helper::compress_result result = kll_helper::general_compress<T, C>(k_, m_, provisional_num_levels, workbuf.get(),
-      worklevels.data(), outlevels.data(), is_level_zero_sorted_);
+      worklevels.data(), outlevels.data(), is_level_zero_sorted_, random_bits_, allocator_);
 
   // ub can sometimes be much bigger
   if (result.final_num_levels > ub) throw std::logic_error("merge error");
@@ -898,9 +1149,10 @@ void kll_sketch<T, C, S, A>::merge_higher_levels(O&& other, uint64_t final_n) {
 }
 
 // this leaves items_ uninitialized (all objects moved out and destroyed)
-// this version copies objects from the incoming sketch
+// this version copies objects from the incoming sketch or serialized levels
 template<typename T, typename C, typename S, typename A>
-void kll_sketch<T, C, S, A>::populate_work_arrays(const kll_sketch& other, T* workbuf, uint32_t* worklevels, uint8_t provisional_num_levels) {
+template<typename O>
+void kll_sketch<T, C, S, A>::populate_work_arrays(const O& other, T* workbuf, uint32_t* worklevels, uint8_t provisional_num_levels) {
   worklevels[0] = 0;
 
   // the level zero data from "other" was already inserted into "this"
@@ -967,6 +1219,18 @@ uint32_t kll_sketch<T, C, S, A>::get_num_retained_above_level_zero() const {
   return levels_[num_levels_] - levels_[1];
 }
 
+template<typename T, typename C, typename S, typename A>
+uint32_t kll_sketch<T, C, S, A>::levels_view::safe_level_size(uint8_t level) const {
+  if (level >= num_levels_) return 0;
+  return levels_[level + 1] - levels_[level];
+}
+
+template<typename T, typename C, typename S, typename A>
+uint32_t kll_sketch<T, C, S, A>::levels_view::get_num_retained_above_level_zero() const {
+  if (num_levels_ == 1) return 0;
+  return levels_[num_levels_] - levels_[1];
+}
+
 template<typename T, typename C, typename S, typename A>
 void kll_sketch<T, C, S, A>::check_m(uint8_t m) {
   if (m != DEFAULT_M) {
@@ -1075,7 +1339,13 @@ typename kll_sketch<T, C, S, A>::const_iterator kll_sketch<T, C, S, A>::end() co
 template<typename T, typename C, typename S, typename A>
 kll_sketch<T, C, S, A>::const_iterator::const_iterator(const T* items, const uint32_t* levels, const uint8_t num_levels):
 items(items), levels(levels), num_levels(num_levels), index(levels == nullptr ? 0 : levels[0]), level(levels == nullptr ? num_levels : 0), weight(1)
-{}
+{
+  // level zero can be empty after a merge
+  while (level < num_levels && levels[level] == levels[level + 1]) {
+    ++level;
+    weight *= 2;
+  }
+}
 
 template<typename T, typename C, typename S, typename A>
 typename kll_sketch<T, C, S, A>::const_iterator& kll_sketch<T, C, S, A>::const_iterator::operator++() {
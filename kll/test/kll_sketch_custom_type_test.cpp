@@ -21,6 +21,7 @@
 #include <sstream>
 
 #include <kll_sketch.hpp>
+#include <arena_allocator.hpp>
 #include <test_allocator.hpp>
 #include <test_type.hpp>
 
@@ -151,4 +152,47 @@ TEST_CASE("kll sketch custom type", "[kll_sketch]") {
   }
 }
 
+TEST_CASE("kll sketch: arena strings", "[kll_sketch]") {
+  using kll_arena_string_sketch = kll_sketch<arena_string, std::less<arena_string>, serde<arena_string>, arena_allocator<arena_string>>;
+  memory_arena arena;
+  arena_allocator<arena_string> allocator(arena);
+  {
+    kll_arena_string_sketch sketch(200, allocator);
+    const int n = 100000;
+    size_t total_bytes = 0;
+    for (int i = 0; i < n; i++) {
+      // long enough not to fit in the string object itself
+      const std::string str = "item with a long name " + std::to_string(100000 + i);
+      sketch.update(arena_string(str.data(), str.size(), allocator));
+      total_bytes += str.size();
+    }
+    REQUIRE(sketch.get_n() == n);
+    REQUIRE(sketch.get_min_value() == "item with a long name 100000");
+    REQUIRE(sketch.get_max_value() == "item with a long name 199999");
+    REQUIRE(sketch.get_min_value().get_allocator() == allocator);
+    // memory freed by compactions is reused
+    REQUIRE(arena.get_reserved_bytes() < total_bytes / 10);
+
+    auto bytes = sketch.serialize();
+    auto sketch2 = kll_arena_string_sketch::deserialize(bytes.data(), bytes.size(), serde<arena_string>(allocator), allocator);
+    REQUIRE(sketch2.get_num_retained() == sketch.get_num_retained());
+    REQUIRE(sketch2.get_quantile(0.5) == sketch.get_quantile(0.5));
+    REQUIRE(sketch2.get_quantile(0.5).get_allocator() == allocator);
+
+    kll_arena_string_sketch sketch4(200, allocator);
+    sketch4.merge_serialized(bytes.data(), bytes.size(), serde<arena_string>(allocator));
+    REQUIRE(sketch4.get_num_retained() == sketch.get_num_retained());
+    REQUIRE(sketch4.get_quantile(0.5) == sketch.get_quantile(0.5));
+    REQUIRE(sketch4.get_quantile(0.5).get_allocator() == allocator);
+
+    // default serde puts items on the heap
+    std::stringstream s(std::ios::in | std::ios::out | std::ios::binary);
+    sketch.serialize(s);
+    auto sketch3 = kll_arena_string_sketch::deserialize(s, allocator);
+    REQUIRE(sketch3.get_quantile(0.5) == sketch.get_quantile(0.5));
+    REQUIRE(sketch3.get_quantile(0.5).get_allocator().get_arena() == nullptr);
+  }
+  REQUIRE(arena.get_allocated_bytes() == 0);
+}
+
 } /* namespace datasketches */
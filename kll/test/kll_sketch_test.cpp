@@ -22,6 +22,11 @@
 #include <cstring>
 #include <sstream>
 #include <fstream>
+#include <thread>
+#include <vector>
+#include <random>
+#include <limits>
+#include <algorithm>
 
 #include <kll_sketch.hpp>
 #include <test_allocator.hpp>
@@ -679,10 +684,336 @@ TEST_CASE("kll sketch", "[kll_sketch]") {
     }
   }
 
+  SECTION("batch update") {
+    const int n = 100000;
+    std::vector<float> values;
+    for (int i = 0; i < n; i++) {
+      values.push_back(static_cast<float>((i * 7919) % n));
+      if (i % 1000 == 0) values.push_back(std::numeric_limits<float>::quiet_NaN());
+    }
+    kll_float_sketch sketch1(200, 0);
+    kll_float_sketch sketch2(200, 0);
+    kll_float_sketch sketch3(200, 0);
+    sketch1.set_random_seed(1);
+    sketch2.set_random_seed(1);
+    sketch3.set_random_seed(1);
+    for (float value: values) sketch1.update(value);
+    // uneven batches, some of which cross the compaction boundary
+    size_t i = 0;
+    size_t batch = 1;
+    while (i < values.size()) {
+      const size_t size = std::min(batch, values.size() - i);
+      sketch2.update(values.data() + i, size);
+      i += size;
+      batch = batch * 3 % 1021 + 1;
+    }
+    sketch3.update(values.begin(), values.end());
+
+    REQUIRE(sketch2.get_n() == static_cast<uint64_t>(n));
+    REQUIRE(sketch2.get_min_value() == 0);
+    REQUIRE(sketch2.get_max_value() == n - 1);
+    for (const kll_float_sketch* sketch: {&sketch2, &sketch3}) {
+      REQUIRE(sketch->get_n() == sketch1.get_n());
+      REQUIRE(sketch->get_num_retained() == sketch1.get_num_retained());
+      REQUIRE(sketch->get_min_value() == sketch1.get_min_value());
+      REQUIRE(sketch->get_max_value() == sketch1.get_max_value());
+      auto it1 = sketch1.begin();
+      auto it2 = sketch->begin();
+      while (it1 != sketch1.end()) {
+        REQUIRE((*it1).first == (*it2).first);
+        REQUIRE((*it1).second == (*it2).second);
+        ++it1;
+        ++it2;
+      }
+    }
+
+    kll_float_sketch sketch4(200, 0);
+    sketch4.update(values.data(), 0);
+    REQUIRE(sketch4.is_empty());
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    sketch4.update(&nan, 1);
+    REQUIRE(sketch4.is_empty());
+  }
+
+  SECTION("batch update of strings") {
+    std::vector<std::string> values;
+    for (int i = 0; i < 1000; i++) values.push_back(std::to_string(i));
+    kll_string_sketch sketch(200, 0);
+    sketch.update(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()));
+    REQUIRE(sketch.get_n() == 1000);
+    REQUIRE(sketch.get_min_value() == "0");
+    REQUIRE(sketch.get_max_value() == "999");
+  }
+
+  SECTION("merge all") {
+    REQUIRE_THROWS_AS(kll_sketch<float>::merge_all((kll_sketch<float>*) nullptr, (kll_sketch<float>*) nullptr, 0), std::invalid_argument);
+    std::vector<kll_sketch<float>> empty_range;
+    REQUIRE(kll_sketch<float>::merge_all(empty_range.begin(), empty_range.end(), 4).is_empty());
+
+    const int num_sketches = 100;
+    const int n = 1000;
+    std::vector<kll_sketch<float>> sketches;
+    for (int s = 0; s < num_sketches; s++) {
+      kll_sketch<float> sketch;
+      // interleaved values, so that every sketch covers the whole range
+      for (int i = 0; i < n; i++) sketch.update(static_cast<float>(i * num_sketches + s));
+      sketches.push_back(std::move(sketch));
+    }
+    const int total = num_sketches * n;
+    for (unsigned num_threads: {1, 3, 8, 200}) {
+      auto result = kll_sketch<float>::merge_all(sketches.begin(), sketches.end(), num_threads);
+      REQUIRE(result.get_n() == static_cast<uint64_t>(total));
+      REQUIRE(result.get_k() == 200);
+      REQUIRE(result.get_min_value() == 0);
+      REQUIRE(result.get_max_value() == total - 1);
+      for (int i = 0; i < total; i += total / 100) {
+        REQUIRE(result.get_rank(static_cast<float>(i)) == Approx(static_cast<double>(i) / total).margin(RANK_EPS_FOR_K_200));
+      }
+    }
+    // inputs are intact
+    REQUIRE(sketches[0].get_n() == static_cast<uint64_t>(n));
+
+    auto result = kll_sketch<float>::merge_all(std::make_move_iterator(sketches.begin()), std::make_move_iterator(sketches.end()), 4);
+    REQUIRE(result.get_n() == static_cast<uint64_t>(total));
+    REQUIRE(result.get_min_value() == 0);
+    REQUIRE(result.get_max_value() == total - 1);
+  }
+
+  SECTION("get ranks") {
+    kll_float_sketch sketch(200, 0);
+    const float empty_values[2] = {0, 1};
+    auto ranks = sketch.get_ranks(empty_values, 2);
+    REQUIRE(ranks.size() == 2);
+    REQUIRE(std::isnan(ranks[0]));
+    REQUIRE(std::isnan(ranks[1]));
+
+    const int n = 100000;
+    for (int i = 0; i < n; i++) sketch.update(static_cast<float>(i));
+    sketch.update(5.0f); // level zero is not sorted
+    // unsorted, with duplicates and values outside of the range
+    std::vector<float> values;
+    for (int i = n + 10; i > -10; i -= 7) values.push_back(static_cast<float>(i));
+    values.push_back(5.0f);
+    values.push_back(5.0f);
+    values.push_back(std::numeric_limits<float>::quiet_NaN());
+    ranks = sketch.get_ranks(values.data(), static_cast<uint32_t>(values.size()));
+    REQUIRE(ranks.size() == values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+      REQUIRE(ranks[i] == sketch.get_rank(values[i]));
+    }
+  }
+
+  SECTION("merge serialized") {
+    std::vector<kll_float_sketch> inputs;
+    inputs.push_back(kll_float_sketch(200, 0)); // empty
+    inputs.push_back(kll_float_sketch(200, 0));
+    inputs.back().update(-5.0f); // single item
+    inputs.push_back(kll_float_sketch(200, 0));
+    for (int i = 0; i < 100; i++) inputs.back().update(static_cast<float>(i)); // exact mode
+    inputs.push_back(kll_float_sketch(100, 0));
+    for (int i = 0; i < 100000; i++) inputs.back().update(static_cast<float>(i)); // estimation mode, lower k
+
+    kll_float_sketch sketch1(200, 0);
+    kll_float_sketch sketch2(200, 0);
+    sketch1.set_random_seed(123);
+    sketch2.set_random_seed(123);
+    for (int i = 0; i < 10000; i++) {
+      sketch1.update(static_cast<float>(-i));
+      sketch2.update(static_cast<float>(-i));
+    }
+    for (int offset = 0; offset < 2; offset++) {
+      for (const auto& input: inputs) {
+        auto bytes = input.serialize(offset); // the offset makes items unaligned
+        sketch1.merge(kll_float_sketch::deserialize(bytes.data() + offset, bytes.size() - offset, 0));
+        sketch2.merge_serialized(bytes.data() + offset, bytes.size() - offset);
+        REQUIRE(sketch2.get_n() == sketch1.get_n());
+        REQUIRE(sketch2.get_min_value() == sketch1.get_min_value());
+        REQUIRE(sketch2.get_max_value() == sketch1.get_max_value());
+        REQUIRE(sketch2.get_normalized_rank_error(false) == sketch1.get_normalized_rank_error(false));
+        auto it1 = sketch1.begin();
+        auto it2 = sketch2.begin();
+        while (it1 != sketch1.end()) {
+          REQUIRE(it2 != sketch2.end());
+          REQUIRE((*it1).first == (*it2).first);
+          REQUIRE((*it1).second == (*it2).second);
+          ++it1;
+          ++it2;
+        }
+        REQUIRE(it2 == sketch2.end());
+      }
+    }
+    // level zero can be empty after a merge, the iterator must skip it
+    uint64_t total_weight = 0;
+    for (auto it: sketch2) total_weight += it.second;
+    REQUIRE(total_weight == sketch2.get_n());
+
+    auto bytes = inputs.back().serialize();
+    REQUIRE_THROWS_AS(sketch2.merge_serialized(bytes.data(), bytes.size() - 1), std::out_of_range);
+    bytes.push_back(0);
+    REQUIRE_THROWS_AS(sketch2.merge_serialized(bytes.data(), bytes.size()), std::logic_error);
+
+    // types that need the serde go through deserialize()
+    kll_string_sketch string_sketch1(200, 0);
+    for (int i = 0; i < 1000; i++) string_sketch1.update(std::to_string(i));
+    auto string_bytes = string_sketch1.serialize();
+    kll_string_sketch string_sketch2(200, 0);
+    string_sketch2.merge_serialized(string_bytes.data(), string_bytes.size());
+    REQUIRE(string_sketch2.get_n() == 1000);
+    REQUIRE(string_sketch2.get_min_value() == "0");
+    REQUIRE(string_sketch2.get_max_value() == "999");
+  }
+
+  SECTION("sorted view") {
+    kll_float_sketch sketch(200, 0);
+    REQUIRE_THROWS_AS(sketch.get_sorted_view(), std::runtime_error);
+    const int n = 100000;
+    for (int i = 0; i < n; i++) sketch.update(static_cast<float>(i));
+    const auto view = sketch.get_sorted_view();
+    REQUIRE(view.get_n() == sketch.get_n());
+    REQUIRE(view.get_num_retained() == sketch.get_num_retained());
+    for (int i = 1; i < 100; i++) {
+      const double fraction = i / 100.0;
+      REQUIRE(view.get_quantile(fraction) == sketch.get_quantile(fraction));
+    }
+    for (int i = -10; i < n + 10; i += 97) {
+      const float value = static_cast<float>(i);
+      REQUIRE(view.get_rank(value) == sketch.get_rank(value));
+    }
+    const float split_points[5] = {-1, 1000, 25000, 50000.5f, 99999};
+    const auto pmf = view.get_PMF(split_points, 5);
+    const auto pmf_expected = sketch.get_PMF(split_points, 5);
+    const auto cdf = view.get_CDF(split_points, 5);
+    const auto cdf_expected = sketch.get_CDF(split_points, 5);
+    REQUIRE(pmf.size() == 6);
+    REQUIRE(cdf.size() == 6);
+    for (int i = 0; i < 6; i++) {
+      REQUIRE(pmf[i] == pmf_expected[i]);
+      REQUIRE(cdf[i] == cdf_expected[i]);
+    }
+    const float unsorted_split_points[2] = {1000, -1};
+    REQUIRE_THROWS_AS(view.get_PMF(unsorted_split_points, 2), std::invalid_argument);
+
+    // the view is a snapshot
+    sketch.update(-1.0f);
+    REQUIRE(view.get_n() == static_cast<uint64_t>(n));
+  }
+
+  SECTION("random seed") {
+    kll_float_sketch sketch1(200, 0);
+    kll_float_sketch sketch2(200, 0);
+    sketch1.set_random_seed(123);
+    sketch2.set_random_seed(123);
+    const int n = 100000;
+    for (int i = 0; i < n; i++) {
+      sketch1.update(static_cast<float>(i));
+      sketch2.update(static_cast<float>(i));
+    }
+    REQUIRE(sketch1.is_estimation_mode());
+    auto it1 = sketch1.begin();
+    auto it2 = sketch2.begin();
+    while (it1 != sketch1.end()) {
+      REQUIRE(it2 != sketch2.end());
+      REQUIRE((*it1).first == (*it2).first);
+      REQUIRE((*it1).second == (*it2).second);
+      ++it1;
+      ++it2;
+    }
+    REQUIRE(it2 == sketch2.end());
+
+    // merge draws from the sketch being merged into
+    kll_float_sketch sketch3(200, 0);
+    kll_float_sketch sketch4(200, 0);
+    sketch3.set_random_seed(456);
+    sketch4.set_random_seed(456);
+    sketch3.merge(sketch1);
+    sketch3.merge(sketch2);
+    sketch4.merge(sketch1);
+    sketch4.merge(sketch2);
+    REQUIRE(sketch3.get_quantile(0.5) == sketch4.get_quantile(0.5));
+    REQUIRE(sketch3.get_num_retained() == sketch4.get_num_retained());
+  }
+
+  SECTION("copies of a prototype") {
+    const int n = 100000;
+    // the default allocator, since test_allocator keeps a global count
+    std::vector<kll_sketch<float>> unseeded(2, kll_sketch<float>(200));
+    kll_sketch<float> prototype(200);
+    prototype.set_random_seed(123);
+    std::vector<kll_sketch<float>> seeded(2, prototype);
+    for (int i = 0; i < n; i++) {
+      for (auto& sketch: unseeded) sketch.update(static_cast<float>(i));
+      for (auto& sketch: seeded) sketch.update(static_cast<float>(i));
+    }
+    // copies of an unseeded sketch draw independent bits
+    REQUIRE(unseeded[0].serialize() != unseeded[1].serialize());
+    // copies of a seeded sketch replay the bits of the prototype
+    REQUIRE(seeded[0].serialize() == seeded[1].serialize());
+  }
+
+  SECTION("independent sketches on separate threads") {
+    const int num_threads = 4;
+    const int n = 100000;
+    // the default allocator, since test_allocator keeps a global count
+    // each sketch is seeded on its own, so the results are reproducible
+    std::vector<kll_sketch<float>> sketches;
+    for (int t = 0; t < num_threads; t++) {
+      sketches.emplace_back(200);
+      sketches.back().set_random_seed(t + 1);
+    }
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+      threads.emplace_back([&sketches, t, n]() {
+        for (int i = 0; i < n; i++) sketches[t].update(static_cast<float>(i));
+      });
+    }
+    for (auto& thread: threads) thread.join();
+    for (const auto& sketch: sketches) {
+      REQUIRE(sketch.get_n() == static_cast<uint64_t>(n));
+      REQUIRE(sketch.get_rank(n / 2) == Approx(0.5).margin(RANK_EPS_FOR_K_200));
+    }
+  }
+
   // cleanup
   if (test_allocator_total_bytes != 0) {
     REQUIRE(test_allocator_total_bytes == 0);
   }
 }
 
+template<typename T>
+static void check_sort_items(size_t n, std::mt19937& gen) {
+  std::uniform_real_distribution<T> dist(-1000, 1000);
+  std::vector<T> values(n);
+  for (auto& value: values) value = dist(gen);
+  const T specials[] = {0, -static_cast<T>(0), std::numeric_limits<T>::infinity(), -std::numeric_limits<T>::infinity(),
+      std::numeric_limits<T>::denorm_min(), -std::numeric_limits<T>::denorm_min(), std::numeric_limits<T>::max(),
+      std::numeric_limits<T>::lowest()};
+  for (size_t i = 0; i < n && i < 8; i++) values[(i * 37) % n] = specials[i];
+  std::vector<T> expected(values);
+  std::sort(expected.begin(), expected.end());
+  kll_helper::sort_items<T, std::less<T>>(values.data(), values.data() + n, std::allocator<T>());
+  for (size_t i = 0; i < n; i++) REQUIRE(values[i] == expected[i]);
+}
+
+TEST_CASE("kll helper: sort items", "[kll_sketch]") {
+  std::mt19937 gen(1);
+  // radix sort starts at 2048 items
+  for (size_t n: {0, 1, 100, 127, 128, 129, 1000, 2047, 2048, 2049, 5000}) {
+    check_sort_items<float>(n, gen);
+    check_sort_items<double>(n, gen);
+  }
+
+  // many equal values in the high digits, which are skipped
+  std::vector<float> values;
+  for (int i = 0; i < 4096; i++) values.push_back(1.0f + (i * 7919 % 4096) * 1e-6f);
+  std::vector<float> expected(values);
+  std::sort(expected.begin(), expected.end());
+  kll_helper::sort_items<float, std::less<float>>(values.data(), values.data() + values.size(), std::allocator<float>());
+  REQUIRE(values == expected);
+
+  // all digits are the same
+  std::vector<double> equal_values(3000, -2.5);
+  kll_helper::sort_items<double, std::less<double>>(equal_values.data(), equal_values.data() + equal_values.size(), std::allocator<double>());
+  REQUIRE(equal_values == std::vector<double>(3000, -2.5));
+}
+
 } /* namespace datasketches */
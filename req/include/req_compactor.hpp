@@ -50,6 +50,10 @@ public:
   template<bool inclusive>
   uint64_t compute_weight(const T& item) const;
 
+  // adds the weights of the given items visited in sorted order given by indices
+  template<bool inclusive>
+  void compute_weights(const T* items, const uint32_t* order, uint32_t size, double* weights) const;
+
   template<typename FwdT>
   void append(FwdT&& item);
 
@@ -161,6 +161,23 @@ uint64_t req_compactor<T, C, A>::compute_weight(const T& item) const {
   return std::distance(begin(), it) << lg_weight_;
 }
 
+template<typename T, typename C, typename A>
+template<bool inclusive>
+void req_compactor<T, C, A>::compute_weights(const T* items, const uint32_t* order, uint32_t size, double* weights) const {
+  if (!sorted_) const_cast<req_compactor*>(this)->sort(); // allow sorting as a side effect
+  const T* it = begin();
+  for (uint32_t i = 0; i < size; ++i) {
+    const T& item = items[order[i]];
+    // same positions as upper_bound or lower_bound in compute_weight()
+    if (inclusive) {
+      while (it != end() && !C()(item, *it)) ++it;
+    } else {
+      while (it != end() && C()(*it, item)) ++it;
+    }
+    weights[order[i]] += static_cast<double>(static_cast<uint64_t>(std::distance(begin(), it)) << lg_weight_);
+  }
+}
+
 template<typename T, typename C, typename A>
 template<typename FwdT>
 void req_compactor<T, C, A>::append(FwdT&& item) {
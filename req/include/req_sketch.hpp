@@ -38,6 +38,8 @@ public:
   using AllocCompactor = typename std::allocator_traits<Allocator>::template rebind_alloc<Compactor>;
   using AllocDouble = typename std::allocator_traits<Allocator>::template rebind_alloc<double>;
   using vector_double = std::vector<double, AllocDouble>;
+  using AllocU32 = typename std::allocator_traits<Allocator>::template rebind_alloc<uint32_t>;
+  using vector_u32 = std::vector<uint32_t, AllocU32>;
 
   /**
    * Constructor
@@ -127,6 +129,21 @@ public:
   template<bool inclusive = false>
   double get_rank(const T& item) const;
 
+  /**
+   * Returns approximations to the normalized ranks of the given items, in the order of the items.
+   * Each rank is the same as get_rank() would return for the item, but the items are sorted once
+   * and every compactor is scanned once for all of them.
+   * The items do not need to be sorted or unique.
+   *
+   * <p>If the sketch is empty this returns NaN for every item.
+   *
+   * @param items an array of items to be ranked
+   * @param size the number of items
+   * @return an array of approximate ranks of the given items
+   */
+  template<bool inclusive = false>
+  vector_double get_ranks(const T* items, uint32_t size) const;
+
   /**
    * Returns an approximation to the Probability Mass Function (PMF) of the input stream
    * given a set of split points (values).
@@ -20,6 +20,7 @@
 #ifndef REQ_SKETCH_IMPL_HPP_
 #define REQ_SKETCH_IMPL_HPP_
 
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
 
@@ -206,6 +207,29 @@ double req_sketch<T, C, S, A>::get_rank(const T& item) const {
   return static_cast<double>(weight) / n_;
 }
 
+template<typename T, typename C, typename S, typename A>
+template<bool inclusive>
+auto req_sketch<T, C, S, A>::get_ranks(const T* items, uint32_t size) const -> vector_double {
+  if (is_empty()) return vector_double(size, std::numeric_limits<double>::quiet_NaN(), allocator_);
+  vector_double ranks(size, 0, allocator_);
+  // indices of the items in sorted order, items that cannot be ordered (NaN) are ranked one by one
+  vector_u32 order(allocator_);
+  order.reserve(size);
+  for (uint32_t i = 0; i < size; ++i) {
+    if (check_update_value(items[i])) {
+      order.push_back(i);
+    } else {
+      ranks[i] = get_rank<inclusive>(items[i]);
+    }
+  }
+  std::sort(order.begin(), order.end(), [items](uint32_t a, uint32_t b) { return C()(items[a], items[b]); });
+  for (const auto& compactor: compactors_) {
+    compactor.template compute_weights<inclusive>(items, order.data(), static_cast<uint32_t>(order.size()), ranks.data());
+  }
+  for (uint32_t i: order) ranks[i] /= n_;
+  return ranks;
+}
+
 template<typename T, typename C, typename S, typename A>
 template<bool inclusive>
 auto req_sketch<T, C, S, A>::get_PMF(const T* split_points, uint32_t size) const -> vector_double {
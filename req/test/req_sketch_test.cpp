@@ -187,6 +187,32 @@ TEST_CASE("req sketch: estimation mode", "[req_sketch]") {
   REQUIRE(count == sketch.get_num_retained());
 }
 
+TEST_CASE("req sketch: get ranks", "[req_sketch]") {
+  req_sketch<float> sketch(12);
+  const float empty_items[2] = {0, 1};
+  auto ranks = sketch.get_ranks(empty_items, 2);
+  REQUIRE(ranks.size() == 2);
+  REQUIRE(std::isnan(ranks[0]));
+  REQUIRE(std::isnan(ranks[1]));
+
+  const int n = 100000;
+  for (int i = 0; i < n; ++i) sketch.update(static_cast<float>(i));
+  // unsorted, with duplicates and items outside of the range
+  std::vector<float> items;
+  for (int i = n + 10; i > -10; i -= 7) items.push_back(static_cast<float>(i));
+  items.push_back(5.0f);
+  items.push_back(5.0f);
+  items.push_back(std::numeric_limits<float>::quiet_NaN());
+  ranks = sketch.get_ranks(items.data(), static_cast<uint32_t>(items.size()));
+  auto inclusive_ranks = sketch.get_ranks<true>(items.data(), static_cast<uint32_t>(items.size()));
+  REQUIRE(ranks.size() == items.size());
+  REQUIRE(inclusive_ranks.size() == items.size());
+  for (size_t i = 0; i < items.size(); ++i) {
+    REQUIRE(ranks[i] == sketch.get_rank(items[i]));
+    REQUIRE(inclusive_ranks[i] == sketch.get_rank<true>(items[i]));
+  }
+}
+
 TEST_CASE("req sketch: stream serialize-deserialize empty", "[req_sketch]") {
   req_sketch<float> sketch(12);
 
@@ -22,6 +22,7 @@
 
 #include "serde.hpp"
 #include "common_defs.hpp"
+#include "xoshiro256.hpp"
 
 #include <iterator>
 #include <vector>
@@ -127,6 +128,17 @@ class var_opt_sketch {
      */
     void reset();
 
+    /**
+     * Seeds the random number generator used by this sketch.
+     * Two sketches seeded identically produce identical samples for identical input.
+     * Unseeded sketches draw their seeds from a per-thread sequence, so independent
+     * sketches can be updated concurrently from different threads.
+     * A copy of a seeded sketch draws the same sequence as its original, and a copy of an
+     * unseeded sketch takes a new seed from the per-thread sequence. The state is not serialized.
+     * @param seed the seed
+     */
+    void set_random_seed(uint64_t seed);
+
     /**
      * Computes size needed to serialize the current state of the sketch.
      * This version is for fixed-size arithmetic types (integral and floating point).
@@ -250,6 +262,9 @@ class var_opt_sketch {
     // occurs and is properly tracked.
     bool* marks_;
 
+    // owned by each sketch so that independent sketches can be updated from different threads
+    xoshiro256 rand_;
+
     // used during deserialization to avoid memory leaks upon errors
     class items_deleter;
     class weights_deleter;
@@ -287,9 +302,9 @@ class var_opt_sketch {
     inline double peek_min() const;
     inline bool is_marked(uint32_t idx) const;
     
-    inline uint32_t pick_random_slot_in_r() const;
-    inline uint32_t choose_delete_slot(double wt_cand, uint32_t num_cand) const;
-    inline uint32_t choose_weighted_delete_slot(double wt_cand, uint32_t num_cand) const;
+    inline uint32_t pick_random_slot_in_r();
+    inline uint32_t choose_delete_slot(double wt_cand, uint32_t num_cand);
+    inline uint32_t choose_weighted_delete_slot(double wt_cand, uint32_t num_cand);
 
     template<typename O>
     inline void push(O&& item, double wt, bool mark);
@@ -320,8 +335,8 @@ class var_opt_sketch {
     static inline double pseudo_hypergeometric_lb_on_p(uint64_t n, uint32_t k, double sampling_rate);
     static bool is_power_of_2(uint32_t v);
     static uint32_t to_log_2(uint32_t v);
-    static inline uint32_t next_int(uint32_t max_value);
-    static inline double next_double_exclude_zero();
+    inline uint32_t next_int(uint32_t max_value);
+    inline double next_double_exclude_zero();
 
     class iterator;
 };
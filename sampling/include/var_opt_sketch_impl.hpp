@@ -60,7 +60,8 @@ var_opt_sketch<T,S,A>::var_opt_sketch(const var_opt_sketch& other) :
   data_(nullptr),
   weights_(nullptr),
   num_marks_in_h_(other.num_marks_in_h_),
-  marks_(nullptr)
+  marks_(nullptr),
+  rand_(other.rand_)
   {
     data_ = allocator_.allocate(curr_items_alloc_);
     // skip gap or anything unused at the end
@@ -97,7 +98,8 @@ var_opt_sketch<T,S,A>::var_opt_sketch(const var_opt_sketch& other, bool as_sketc
   data_(nullptr),
   weights_(nullptr),
   num_marks_in_h_(other.num_marks_in_h_),
-  marks_(nullptr)
+  marks_(nullptr),
+  rand_(other.rand_)
   {
     data_ = allocator_.allocate(curr_items_alloc_);
     // skip gap or anything unused at the end
@@ -153,7 +155,8 @@ var_opt_sketch<T,S,A>::var_opt_sketch(var_opt_sketch&& other) noexcept :
   data_(other.data_),
   weights_(other.weights_),
   num_marks_in_h_(other.num_marks_in_h_),
-  marks_(other.marks_)
+  marks_(other.marks_),
+  rand_(std::move(other.rand_))
   {
     other.data_ = nullptr;
     other.weights_ = nullptr;
@@ -248,6 +251,7 @@ var_opt_sketch<T,S,A>& var_opt_sketch<T,S,A>::operator=(const var_opt_sketch& ot
   std::swap(weights_, sk_copy.weights_);
   std::swap(num_marks_in_h_, sk_copy.num_marks_in_h_);
   std::swap(marks_, sk_copy.marks_);
+  std::swap(rand_, sk_copy.rand_);
   return *this;
 }
 
@@ -267,6 +271,7 @@ var_opt_sketch<T,S,A>& var_opt_sketch<T,S,A>::operator=(var_opt_sketch&& other)
   std::swap(weights_, other.weights_);
   std::swap(num_marks_in_h_, other.num_marks_in_h_);
   std::swap(marks_, other.marks_);
+  std::swap(rand_, other.rand_);
   return *this;
 }
 
@@ -667,6 +672,11 @@ bool var_opt_sketch<T,S,A>::is_empty() const {
   return (h_ == 0 && r_ == 0);
 }
 
+template<typename T, typename S, typename A>
+void var_opt_sketch<T,S,A>::set_random_seed(uint64_t seed) {
+  rand_.seed(seed);
+}
+
 template<typename T, typename S, typename A>
 void var_opt_sketch<T,S,A>::reset() {
   const uint32_t prev_alloc = curr_items_alloc_;
@@ -1223,7 +1233,7 @@ void var_opt_sketch<T,S,A>::downsample_candidate_set(double wt_cands, uint32_t n
 }
 
 template<typename T, typename S, typename A>
-uint32_t var_opt_sketch<T,S,A>::choose_delete_slot(double wt_cands, uint32_t num_cands) const {
+uint32_t var_opt_sketch<T,S,A>::choose_delete_slot(double wt_cands, uint32_t num_cands) {
   if (r_ == 0) throw std::logic_error("choosing delete slot while in exact mode");
 
   if (m_ == 0) {
@@ -1251,7 +1261,7 @@ uint32_t var_opt_sketch<T,S,A>::choose_delete_slot(double wt_cands, uint32_t num
 }
 
 template<typename T, typename S, typename A>
-uint32_t var_opt_sketch<T,S,A>::choose_weighted_delete_slot(double wt_cands, uint32_t num_cands) const {
+uint32_t var_opt_sketch<T,S,A>::choose_weighted_delete_slot(double wt_cands, uint32_t num_cands) {
   if (m_ < 1) throw std::logic_error("must have weighted delete slot");
 
   const uint32_t offset = h_;
@@ -1275,7 +1285,7 @@ uint32_t var_opt_sketch<T,S,A>::choose_weighted_delete_slot(double wt_cands, uin
 }
 
 template<typename T, typename S, typename A>
-uint32_t var_opt_sketch<T,S,A>::pick_random_slot_in_r() const {
+uint32_t var_opt_sketch<T,S,A>::pick_random_slot_in_r() {
   if (r_ == 0) throw std::logic_error("r_ = 0 when picking slot in R region");
   const uint32_t offset = h_ + m_;
   if (r_ == 1) {
@@ -1690,12 +1700,6 @@ bool var_opt_sketch<T, S, A>::iterator::get_mark() const {
 
 // ******************** MOVE TO COMMON UTILS AREA EVENTUALLY *********************
 
-namespace random_utils {
-  static std::random_device rd; // possibly unsafe in MinGW with GCC < 9.2
-  static std::mt19937_64 rand(rd());
-  static std::uniform_real_distribution<> next_double(0.0, 1.0);
-}
-
 /**
  * Checks if target sampling allocation is more than 50% of max sampling size.
  * If so, returns max sampling size, otherwise passes through target size.
@@ -1745,14 +1749,14 @@ uint32_t var_opt_sketch<T,S,A>::to_log_2(uint32_t v) {
 template<typename T, typename S, typename A>
 uint32_t var_opt_sketch<T,S,A>::next_int(uint32_t max_value) {
   std::uniform_int_distribution<uint32_t> dist(0, max_value - 1);
-  return dist(random_utils::rand);
+  return dist(rand_);
 }
 
 template<typename T, typename S, typename A>
 double var_opt_sketch<T,S,A>::next_double_exclude_zero() {
-  double r = random_utils::next_double(random_utils::rand);
+  double r = rand_.next_double();
   while (r == 0.0) {
-    r = random_utils::next_double(random_utils::rand);
+    r = rand_.next_double();
   }
   return r;
 }
@@ -85,6 +85,13 @@ public:
    */
   void reset();
 
+  /**
+   * Seeds the random number generator used when merging sketches into this union.
+   * Two unions seeded identically produce identical results for identical input.
+   * @param seed the seed
+   */
+  void set_random_seed(uint64_t seed);
+
   /**
    * Computes size needed to serialize the current state of the union.
    * This version is for all other types and can be expensive since every item needs to be looked at.
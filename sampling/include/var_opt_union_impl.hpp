@@ -301,6 +301,11 @@ void var_opt_union<T,S,A>::reset() {
   gadget_.reset();
 }
 
+template<typename T, typename S, typename A>
+void var_opt_union<T,S,A>::set_random_seed(uint64_t seed) {
+  gadget_.set_random_seed(seed);
+}
+
 template<typename T, typename S, typename A>
 string<A> var_opt_union<T,S,A>::to_string() const {
   std::basic_ostringstream<char, std::char_traits<char>, AllocChar<A>> os;
@@ -27,6 +27,7 @@
 #include <fstream>
 #include <cmath>
 #include <random>
+#include <thread>
 
 #ifdef TEST_BINARY_INPUT_PATH
 static std::string testBinaryInputPath = TEST_BINARY_INPUT_PATH;
@@ -506,4 +507,65 @@ TEST_CASE("varopt sketch: deserialize sampling from java", "[var_opt_sketch]") {
   REQUIRE(ss.estimate == Approx(2000.0).margin(EPS));
 }
 
+TEST_CASE("varopt sketch: random seed", "[var_opt_sketch]") {
+  const uint32_t k = 256;
+  var_opt_sketch<int> sk1(k);
+  var_opt_sketch<int> sk2(k);
+  sk1.set_random_seed(123);
+  sk2.set_random_seed(123);
+  for (int i = 1; i <= 10000; ++i) {
+    sk1.update(i, 1.0 + i % 7);
+    sk2.update(i, 1.0 + i % 7);
+  }
+  REQUIRE(sk1.get_num_samples() == k);
+  check_if_equal(sk1, sk2);
+
+  // copies carry the generator state along
+  var_opt_sketch<int> sk3(sk1);
+  sk1.update(0, 100.0);
+  sk3.update(0, 100.0);
+  check_if_equal(sk1, sk3);
+}
+
+TEST_CASE("varopt sketch: independent sketches on separate threads", "[var_opt_sketch]") {
+  const uint32_t k = 256;
+  const int num_threads = 4;
+  const uint64_t n = 100000;
+  std::vector<var_opt_sketch<int>> sketches;
+  for (int t = 0; t < num_threads; ++t) sketches.emplace_back(k);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&sketches, t, n]() {
+      for (uint64_t i = 0; i < n; ++i) sketches[t].update(static_cast<int>(i), 1.0);
+    });
+  }
+  for (auto& thread: threads) thread.join();
+  for (const auto& sketch: sketches) {
+    REQUIRE(sketch.get_n() == n);
+    REQUIRE(sketch.get_num_samples() == k);
+    subset_summary ss = sketch.estimate_subset_sum([](int){ return true; });
+    REQUIRE(ss.estimate == Approx(static_cast<double>(n)).margin(EPS * n));
+  }
+  for (int t = 1; t < num_threads; ++t) {
+    REQUIRE(sketches[t].serialize() != sketches[0].serialize());
+  }
+}
+
+TEST_CASE("varopt sketch: copies of a prototype", "[var_opt_sketch]") {
+  const uint32_t k = 256;
+  const uint64_t n = 100000;
+  std::vector<var_opt_sketch<int>> unseeded(2, var_opt_sketch<int>(k));
+  var_opt_sketch<int> prototype(k);
+  prototype.set_random_seed(123);
+  std::vector<var_opt_sketch<int>> seeded(2, prototype);
+  for (uint64_t i = 0; i < n; ++i) {
+    for (auto& sk: unseeded) sk.update(static_cast<int>(i), 1.0);
+    for (auto& sk: seeded) sk.update(static_cast<int>(i), 1.0);
+  }
+  // copies of an unseeded sketch draw independent samples
+  REQUIRE(unseeded[0].serialize() != unseeded[1].serialize());
+  // copies of a seeded sketch replay the prototype
+  check_if_equal(seeded[0], seeded[1]);
+}
+
 }
@@ -324,4 +324,23 @@ TEST_CASE("varopt union: deserialize from java", "[var_opt_union]") {
   REQUIRE(result.get_k() < 128);
 }
 
+TEST_CASE("varopt union: random seed", "[var_opt_union]") {
+  const uint32_t k = 128;
+  var_opt_union<int> u1(k);
+  var_opt_union<int> u2(k);
+  u1.set_random_seed(321);
+  u2.set_random_seed(321);
+  for (int s = 0; s < 8; ++s) {
+    var_opt_sketch<int> sk(k);
+    sk.set_random_seed(s);
+    for (int i = 0; i < 1000; ++i) sk.update(s * 1000 + i, 1.0 + i % 5);
+    u1.update(sk);
+    u2.update(sk);
+  }
+  var_opt_sketch<int> result1 = u1.get_result();
+  var_opt_sketch<int> result2 = u2.get_result();
+  REQUIRE(result1.get_num_samples() == k);
+  check_if_equal(result1, result2);
+}
+
 }
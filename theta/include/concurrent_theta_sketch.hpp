@@ -0,0 +1,327 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef CONCURRENT_THETA_SKETCH_HPP_
+#define CONCURRENT_THETA_SKETCH_HPP_
+
+#include <atomic>
+#include <mutex>
+
+#include "theta_sketch.hpp"
+
+namespace datasketches {
+
+/**
+ * Theta sketch that can be updated from many threads at the same time.
+ *
+ * The sketch itself holds the shared hash table protected by a mutex.
+ * Writer threads never touch the shared table per update. Instead each writer thread
+ * obtains its own local_buffer, which accumulates hashes in a small local table
+ * and propagates them to the shared table in batches.
+ * The state of the shared table (theta, number of retained entries, emptiness) is published
+ * after every propagation under a sequence lock, so the local buffers screen incoming hashes
+ * against the published theta and queries read the published state without taking the mutex.
+ *
+ * Queries (estimate, bounds, theta) reflect the state as of the last propagation,
+ * and each of them sees theta and the number of retained entries from the same propagation.
+ * A consistent snapshot of the entries can be obtained using compact().
+ * Updates sitting in local buffers become visible after the buffer propagates,
+ * which happens when it fills up or when flush() is called.
+ */
+template<typename Allocator = std::allocator<uint64_t>>
+class concurrent_theta_sketch_alloc {
+public:
+  using Entry = uint64_t;
+  using ExtractKey = trivial_extract_key;
+  using theta_table = theta_update_sketch_base<Entry, ExtractKey, Allocator>;
+  using resize_factor = typename theta_table::resize_factor;
+  using CompactSketch = compact_theta_sketch_alloc<Allocator>;
+
+  // No constructor here. Use builder instead.
+  class builder;
+  class local_buffer;
+
+  /**
+   * Move constructor.
+   * Must not be used while there are live local buffers attached to the other sketch.
+   */
+  concurrent_theta_sketch_alloc(concurrent_theta_sketch_alloc&& other) noexcept;
+
+  concurrent_theta_sketch_alloc(const concurrent_theta_sketch_alloc&) = delete;
+  concurrent_theta_sketch_alloc& operator=(const concurrent_theta_sketch_alloc&) = delete;
+  concurrent_theta_sketch_alloc& operator=(concurrent_theta_sketch_alloc&&) = delete;
+
+  /**
+   * Creates a buffer to update this sketch from one thread.
+   * Each writer thread must use its own buffer.
+   * The buffer must not outlive this sketch.
+   * @return local buffer attached to this sketch
+   */
+  local_buffer get_local_buffer();
+
+  /**
+   * @return true if this sketch represents an empty set (not the same as no retained entries!)
+   */
+  bool is_empty() const;
+
+  /**
+   * @return estimate of the distinct count of the input stream
+   */
+  double get_estimate() const;
+
+  /**
+   * Returns the approximate lower error bound given a number of standard deviations.
+   * @param num_std_devs number of Standard Deviations (1, 2 or 3)
+   * @return the lower bound
+   */
+  double get_lower_bound(uint8_t num_std_devs) const;
+
+  /**
+   * Returns the approximate upper error bound given a number of standard deviations.
+   * @param num_std_devs number of Standard Deviations (1, 2 or 3)
+   * @return the upper bound
+   */
+  double get_upper_bound(uint8_t num_std_devs) const;
+
+  /**
+   * @return true if the sketch is in estimation mode (as opposed to exact mode)
+   */
+  bool is_estimation_mode() const;
+
+  /**
+   * @return theta as a fraction from 0 to 1 (effective sampling rate)
+   */
+  double get_theta() const;
+
+  /**
+   * @return theta as a positive integer between 0 and LLONG_MAX
+   */
+  uint64_t get_theta64() const;
+
+  /**
+   * @return the number of retained entries in the shared table
+   */
+  uint32_t get_num_retained() const;
+
+  /**
+   * @return hash of the seed that was used to hash the input
+   */
+  uint16_t get_seed_hash() const;
+
+  /**
+   * @return configured nominal number of entries in the sketch
+   */
+  uint8_t get_lg_k() const;
+
+  /**
+   * @return configured nominal number of entries in each local buffer
+   */
+  uint8_t get_local_lg_k() const;
+
+  /**
+   * Produces a consistent snapshot of the shared table as a compact sketch.
+   * Entries that are still held in local buffers are not included.
+   * @param ordered optional flag to specify if ordered sketch should be produced
+   * @return compact sketch
+   */
+  CompactSketch compact(bool ordered = true) const;
+
+private:
+  // published state, read together by queries
+  struct snapshot {
+    bool is_empty;
+    uint64_t theta;
+    uint32_t num_retained;
+  };
+
+  mutable std::mutex mutex_;
+  theta_table table_;
+  uint8_t local_lg_k_;
+  // sequence lock: odd while propagate() is publishing a new state
+  std::atomic<uint32_t> published_version_;
+  std::atomic<bool> published_is_empty_;
+  std::atomic<uint64_t> published_theta_;
+  std::atomic<uint32_t> published_num_retained_;
+
+  // for builder
+  concurrent_theta_sketch_alloc(uint8_t lg_cur_size, uint8_t lg_nom_size, resize_factor rf, uint64_t theta,
+      uint64_t seed, uint8_t local_lg_k, const Allocator& allocator);
+
+  // must be called with the mutex held
+  void propagate(const theta_table& buffer);
+  snapshot load_snapshot() const;
+};
+
+/**
+ * Per-thread writer for the concurrent theta sketch.
+ * Hashes are screened against the published theta of the shared sketch
+ * and collected in a small local table until 2^local_lg_k of them are accumulated.
+ * At that point the buffer tries to propagate them to the shared sketch.
+ * If the shared sketch is busy with another propagation, the buffer keeps accumulating
+ * up to twice its nominal size before it waits for the lock.
+ * Call flush() when done updating. The destructor flushes too, but it cannot report errors,
+ * so if the final propagation fails there (for instance, runs out of memory), the buffered hashes are lost.
+ * Not thread safe: one instance must be used by one thread at a time.
+ */
+template<typename Allocator>
+class concurrent_theta_sketch_alloc<Allocator>::local_buffer {
+public:
+  local_buffer(local_buffer&& other) noexcept;
+  ~local_buffer();
+
+  local_buffer(const local_buffer&) = delete;
+  local_buffer& operator=(const local_buffer&) = delete;
+  local_buffer& operator=(local_buffer&&) = delete;
+
+  /**
+   * Update with a given string.
+   * @param value string to update the sketch with
+   */
+  void update(const std::string& value);
+
+  /**
+   * Update with a given unsigned 64-bit integer.
+   * @param value uint64_t to update the sketch with
+   */
+  void update(uint64_t value);
+
+  /**
+   * Update with a given signed 64-bit integer.
+   * @param value int64_t to update the sketch with
+   */
+  void update(int64_t value);
+
+  /**
+   * Update with a given unsigned 32-bit integer.
+   * For compatibility with Java implementation.
+   * @param value uint32_t to update the sketch with
+   */
+  void update(uint32_t value);
+
+  /**
+   * Update with a given signed 32-bit integer.
+   * For compatibility with Java implementation.
+   * @param value int32_t to update the sketch with
+   */
+  void update(int32_t value);
+
+  /**
+   * Update with a given unsigned 16-bit integer.
+   * For compatibility with Java implementation.
+   * @param value uint16_t to update the sketch with
+   */
+  void update(uint16_t value);
+
+  /**
+   * Update with a given signed 16-bit integer.
+   * For compatibility with Java implementation.
+   * @param value int16_t to update the sketch with
+   */
+  void update(int16_t value);
+
+  /**
+   * Update with a given unsigned 8-bit integer.
+   * For compatibility with Java implementation.
+   * @param value uint8_t to update the sketch with
+   */
+  void update(uint8_t value);
+
+  /**
+   * Update with a given signed 8-bit integer.
+   * For compatibility with Java implementation.
+   * @param value int8_t to update the sketch with
+   */
+  void update(int8_t value);
+
+  /**
+   * Update with a given double-precision floating point value.
+   * For compatibility with Java implementation.
+   * @param value double to update the sketch with
+   */
+  void update(double value);
+
+  /**
+   * Update with a given floating point value.
+   * For compatibility with Java implementation.
+   * @param value float to update the sketch with
+   */
+  void update(float value);
+
+  /**
+   * Update with given data of any type.
+   * See update_theta_sketch_alloc::update(const void*, size_t) for the caveats.
+   * @param data pointer to the data
+   * @param length of the data in bytes
+   */
+  void update(const void* data, size_t length);
+
+  /**
+   * Propagates all buffered hashes to the shared sketch, waiting for the lock if necessary.
+   */
+  void flush();
+
+private:
+  friend class concurrent_theta_sketch_alloc;
+
+  concurrent_theta_sketch_alloc* shared_;
+  theta_table buffer_;
+  uint32_t max_size_;
+
+  explicit local_buffer(concurrent_theta_sketch_alloc& shared);
+
+  void propagate_if_full();
+  void propagate_and_clear();
+};
+
+template<typename Allocator>
+class concurrent_theta_sketch_alloc<Allocator>::builder: public theta_base_builder<builder, Allocator> {
+public:
+  static const uint8_t DEFAULT_LOCAL_LG_K = 4;
+  // local tables are 4 times the nominal size of a buffer, and no theta table is smaller than 2^MIN_LG_K
+  static const uint8_t MIN_LOCAL_LG_K = theta_constants::MIN_LG_K - 2;
+
+  builder(const Allocator& allocator = Allocator());
+
+  /**
+   * Set log2 of the number of hashes each local buffer accumulates before propagating to the shared sketch.
+   * Larger buffers mean less contention on the shared sketch, but staler query results.
+   * Must not be less than MIN_LOCAL_LG_K or greater than lg_k.
+   * @param local_lg_k base 2 logarithm of the nominal size of local buffers
+   * @return this builder
+   */
+  builder& set_local_lg_k(uint8_t local_lg_k);
+
+  /**
+   * This is to create an instance of the sketch with predefined parameters.
+   * @return an instance of the sketch
+   */
+  concurrent_theta_sketch_alloc build() const;
+
+private:
+  uint8_t local_lg_k_;
+};
+
+// alias with default allocator for convenience
+using concurrent_theta_sketch = concurrent_theta_sketch_alloc<std::allocator<uint64_t>>;
+
+} /* namespace datasketches */
+
+#include "concurrent_theta_sketch_impl.hpp"
+
+#endif
@@ -0,0 +1,321 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#ifndef CONCURRENT_THETA_SKETCH_IMPL_HPP_
+#define CONCURRENT_THETA_SKETCH_IMPL_HPP_
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "binomial_bounds.hpp"
+
+namespace datasketches {
+
+template<typename A>
+concurrent_theta_sketch_alloc<A>::concurrent_theta_sketch_alloc(uint8_t lg_cur_size, uint8_t lg_nom_size, resize_factor rf,
+    uint64_t theta, uint64_t seed, uint8_t local_lg_k, const A& allocator):
+table_(lg_cur_size, lg_nom_size, rf, theta, seed, allocator),
+local_lg_k_(local_lg_k),
+published_version_(0),
+published_is_empty_(true),
+published_theta_(theta),
+published_num_retained_(0)
+{}
+
+template<typename A>
+concurrent_theta_sketch_alloc<A>::concurrent_theta_sketch_alloc(concurrent_theta_sketch_alloc&& other) noexcept:
+table_(std::move(other.table_)),
+local_lg_k_(other.local_lg_k_),
+published_version_(other.published_version_.load()),
+published_is_empty_(other.published_is_empty_.load()),
+published_theta_(other.published_theta_.load()),
+published_num_retained_(other.published_num_retained_.load())
+{}
+
+template<typename A>
+auto concurrent_theta_sketch_alloc<A>::get_local_buffer() -> local_buffer {
+  return local_buffer(*this);
+}
+
+template<typename A>
+bool concurrent_theta_sketch_alloc<A>::is_empty() const {
+  return published_is_empty_.load(std::memory_order_acquire);
+}
+
+template<typename A>
+double concurrent_theta_sketch_alloc<A>::get_estimate() const {
+  const snapshot state = load_snapshot();
+  return state.num_retained / (static_cast<double>(state.theta) / theta_constants::MAX_THETA);
+}
+
+template<typename A>
+double concurrent_theta_sketch_alloc<A>::get_lower_bound(uint8_t num_std_devs) const {
+  const snapshot state = load_snapshot();
+  const double theta = static_cast<double>(state.theta) / theta_constants::MAX_THETA;
+  if (theta == 1.0 || state.is_empty) return state.num_retained;
+  return binomial_bounds::get_lower_bound(state.num_retained, theta, num_std_devs);
+}
+
+template<typename A>
+double concurrent_theta_sketch_alloc<A>::get_upper_bound(uint8_t num_std_devs) const {
+  const snapshot state = load_snapshot();
+  const double theta = static_cast<double>(state.theta) / theta_constants::MAX_THETA;
+  if (theta == 1.0 || state.is_empty) return state.num_retained;
+  return binomial_bounds::get_upper_bound(state.num_retained, theta, num_std_devs);
+}
+
+template<typename A>
+bool concurrent_theta_sketch_alloc<A>::is_estimation_mode() const {
+  const snapshot state = load_snapshot();
+  return state.theta < theta_constants::MAX_THETA && !state.is_empty;
+}
+
+template<typename A>
+double concurrent_theta_sketch_alloc<A>::get_theta() const {
+  return static_cast<double>(get_theta64()) / theta_constants::MAX_THETA;
+}
+
+template<typename A>
+uint64_t concurrent_theta_sketch_alloc<A>::get_theta64() const {
+  return published_theta_.load(std::memory_order_acquire);
+}
+
+template<typename A>
+uint32_t concurrent_theta_sketch_alloc<A>::get_num_retained() const {
+  return published_num_retained_.load(std::memory_order_acquire);
+}
+
+template<typename A>
+uint16_t concurrent_theta_sketch_alloc<A>::get_seed_hash() const {
+  return compute_seed_hash(table_.seed_);
+}
+
+template<typename A>
+uint8_t concurrent_theta_sketch_alloc<A>::get_lg_k() const {
+  return table_.lg_nom_size_;
+}
+
+template<typename A>
+uint8_t concurrent_theta_sketch_alloc<A>::get_local_lg_k() const {
+  return local_lg_k_;
+}
+
+template<typename A>
+auto concurrent_theta_sketch_alloc<A>::compact(bool ordered) const -> CompactSketch {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<uint64_t, A> entries(table_.allocator_);
+  entries.reserve(table_.num_entries_);
+  std::copy_if(table_.begin(), table_.end(), std::back_inserter(entries), key_not_zero<Entry, ExtractKey>());
+  if (ordered) std::sort(entries.begin(), entries.end());
+  return CompactSketch(table_.is_empty_, ordered, compute_seed_hash(table_.seed_), table_.theta_, std::move(entries));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::propagate(const theta_table& buffer) {
+  if (!buffer.is_empty_) table_.is_empty_ = false;
+  for (auto it = buffer.begin(); it != buffer.end(); ++it) {
+    const uint64_t hash = *it;
+    // theta of the shared table might have been reduced since the buffer screened this hash
+    if (hash != 0 && hash < table_.theta_) {
+      auto result = table_.find(hash);
+      if (!result.second) table_.insert(result.first, hash);
+    }
+  }
+  // writers are serialized by the mutex, so the version can be bumped without a read-modify-write
+  const uint32_t version = published_version_.load(std::memory_order_relaxed);
+  published_version_.store(version + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  published_num_retained_.store(table_.num_entries_, std::memory_order_relaxed);
+  published_theta_.store(table_.theta_, std::memory_order_relaxed);
+  published_is_empty_.store(table_.is_empty_, std::memory_order_relaxed);
+  published_version_.store(version + 2, std::memory_order_release);
+}
+
+// retries until it reads all fields without a propagation publishing in between
+template<typename A>
+auto concurrent_theta_sketch_alloc<A>::load_snapshot() const -> snapshot {
+  while (true) {
+    const uint32_t version = published_version_.load(std::memory_order_acquire);
+    if (version & 1) continue;
+    snapshot state;
+    state.num_retained = published_num_retained_.load(std::memory_order_relaxed);
+    state.theta = published_theta_.load(std::memory_order_relaxed);
+    state.is_empty = published_is_empty_.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (published_version_.load(std::memory_order_relaxed) == version) return state;
+  }
+}
+
+// local buffer
+
+template<typename A>
+concurrent_theta_sketch_alloc<A>::local_buffer::local_buffer(concurrent_theta_sketch_alloc& shared):
+shared_(&shared),
+// the local table is sized to hold twice the nominal number of entries without resizing
+buffer_(shared.local_lg_k_ + 2, shared.local_lg_k_ + 2, resize_factor::X1, theta_constants::MAX_THETA,
+    shared.table_.seed_, shared.table_.allocator_),
+max_size_(1 << shared.local_lg_k_)
+{}
+
+template<typename A>
+concurrent_theta_sketch_alloc<A>::local_buffer::local_buffer(local_buffer&& other) noexcept:
+shared_(other.shared_),
+buffer_(std::move(other.buffer_)),
+max_size_(other.max_size_)
+{
+  other.shared_ = nullptr;
+}
+
+// a destructor must not throw, so if the final propagation fails, the buffered hashes are dropped
+template<typename A>
+concurrent_theta_sketch_alloc<A>::local_buffer::~local_buffer() {
+  try {
+    flush();
+  } catch (...) {}
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(uint64_t value) {
+  update(&value, sizeof(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(int64_t value) {
+  update(&value, sizeof(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(uint32_t value) {
+  update(static_cast<int32_t>(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(int32_t value) {
+  update(static_cast<int64_t>(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(uint16_t value) {
+  update(static_cast<int16_t>(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(int16_t value) {
+  update(static_cast<int64_t>(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(uint8_t value) {
+  update(static_cast<int8_t>(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(int8_t value) {
+  update(static_cast<int64_t>(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(double value) {
+  update(canonical_double(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(float value) {
+  update(static_cast<double>(value));
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(const std::string& value) {
+  if (value.empty()) return;
+  update(value.c_str(), value.length());
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::update(const void* data, size_t length) {
+  buffer_.is_empty_ = false;
+  const uint64_t hash = compute_hash(data, length, buffer_.seed_);
+  if (hash >= shared_->published_theta_.load(std::memory_order_relaxed)) return;
+  auto result = buffer_.find(hash);
+  if (!result.second) {
+    buffer_.insert(result.first, hash);
+    propagate_if_full();
+  }
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::flush() {
+  if (shared_ == nullptr) return;
+  if (buffer_.num_entries_ == 0 && buffer_.is_empty_) return;
+  std::lock_guard<std::mutex> lock(shared_->mutex_);
+  propagate_and_clear();
+}
+
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::propagate_if_full() {
+  if (buffer_.num_entries_ < max_size_) return;
+  std::unique_lock<std::mutex> lock(shared_->mutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    // another thread is propagating, keep buffering unless there is no more room
+    if (buffer_.num_entries_ < 2 * max_size_) return;
+    lock.lock();
+  }
+  propagate_and_clear();
+}
+
+// must be called with the mutex of the shared sketch held
+template<typename A>
+void concurrent_theta_sketch_alloc<A>::local_buffer::propagate_and_clear() {
+  shared_->propagate(buffer_);
+  const size_t size = 1 << buffer_.lg_cur_size_;
+  for (size_t i = 0; i < size; ++i) buffer_.entries_[i] = 0;
+  buffer_.num_entries_ = 0;
+  buffer_.is_empty_ = true;
+}
+
+// builder
+
+template<typename A>
+concurrent_theta_sketch_alloc<A>::builder::builder(const A& allocator):
+theta_base_builder<builder, A>(allocator), local_lg_k_(DEFAULT_LOCAL_LG_K) {}
+
+template<typename A>
+auto concurrent_theta_sketch_alloc<A>::builder::set_local_lg_k(uint8_t local_lg_k) -> builder& {
+  if (local_lg_k < MIN_LOCAL_LG_K) {
+    throw std::invalid_argument("local_lg_k must not be less than " + std::to_string(MIN_LOCAL_LG_K) + ": " + std::to_string(local_lg_k));
+  }
+  if (local_lg_k > this->MAX_LG_K) {
+    throw std::invalid_argument("local_lg_k must not be greater than " + std::to_string(this->MAX_LG_K) + ": " + std::to_string(local_lg_k));
+  }
+  local_lg_k_ = local_lg_k;
+  return *this;
+}
+
+template<typename A>
+auto concurrent_theta_sketch_alloc<A>::builder::build() const -> concurrent_theta_sketch_alloc {
+  if (local_lg_k_ > this->lg_k_) {
+    throw std::invalid_argument("local_lg_k must not be greater than lg_k: " + std::to_string(local_lg_k_));
+  }
+  return concurrent_theta_sketch_alloc(this->starting_lg_size(), this->lg_k_, this->rf_, this->starting_theta(),
+      this->seed_, local_lg_k_, this->allocator_);
+}
+
+} /* namespace datasketches */
+
+#endif
@@ -20,6 +20,10 @@
 #ifndef THETA_COMPARATORS_HPP_
 #define THETA_COMPARATORS_HPP_
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
 namespace datasketches {
 
 template<typename ExtractKey>
@@ -30,6 +34,30 @@ struct compare_by_key {
   }
 };
 
+// compares the key of an entry with a key value, for binary search over sorted entries
+template<typename ExtractKey>
+struct compare_key_with_value {
+  template<typename Entry, typename Key>
+  bool operator()(const Entry& entry, const Key& key) const {
+    return ExtractKey()(entry) < key;
+  }
+};
+
+// lower bound search starting with exponentially growing steps from the beginning of the range,
+// so that a sequence of increasing searches costs O(log(distance)) each
+template<typename ExtractKey, typename It>
+It gallop_lower_bound(It first, It last, uint64_t key) {
+  if (first == last || !(ExtractKey()(*first) < key)) return first;
+  const size_t size = last - first;
+  size_t lo = 0; // known to be less than key
+  size_t hi = 1;
+  while (hi < size && ExtractKey()(first[hi]) < key) {
+    lo = hi;
+    hi *= 2;
+  }
+  return std::lower_bound(first + lo + 1, first + std::min(hi, size), key, compare_key_with_value<ExtractKey>());
+}
+
 // less than
 
 template<typename Key, typename Entry, typename ExtractKey>
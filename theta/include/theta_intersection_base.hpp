@@ -50,6 +50,13 @@ private:
   Policy policy_;
   bool is_valid_;
   hash_table table_;
+  // while all inputs are ordered, the intersection is kept as a sorted array instead of the hash table
+  bool is_sorted_;
+  std::vector<Entry, Allocator> sorted_entries_;
+
+  template<typename FwdSketch>
+  void intersect_sorted(FwdSketch&& sketch);
+  void convert_to_hash_table();
 };
 
 } /* namespace datasketches */
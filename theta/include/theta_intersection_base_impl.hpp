@@ -29,7 +29,9 @@ template<typename EN, typename EK, typename P, typename S, typename CS, typename
 theta_intersection_base<EN, EK, P, S, CS, A>::theta_intersection_base(uint64_t seed, const P& policy, const A& allocator):
 policy_(policy),
 is_valid_(false),
-table_(0, 0, resize_factor::X1, theta_constants::MAX_THETA, seed, allocator, false)
+table_(0, 0, resize_factor::X1, theta_constants::MAX_THETA, seed, allocator, false),
+is_sorted_(true),
+sorted_entries_(allocator)
 {}
 
 template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
@@ -39,12 +41,20 @@ void theta_intersection_base<EN, EK, P, S, CS, A>::update(SS&& sketch) {
   if (!sketch.is_empty() && sketch.get_seed_hash() != compute_seed_hash(table_.seed_)) throw std::invalid_argument("seed hash mismatch");
   table_.is_empty_ |= sketch.is_empty();
   table_.theta_ = std::min(table_.theta_, sketch.get_theta64());
-  if (is_valid_ && table_.num_entries_ == 0) return;
+  if (is_valid_ && (is_sorted_ ? sorted_entries_.empty() : table_.num_entries_ == 0)) return;
   if (sketch.get_num_retained() == 0) {
     is_valid_ = true;
     table_ = hash_table(0, 0, resize_factor::X1, table_.theta_, table_.seed_, table_.allocator_, table_.is_empty_);
+    sorted_entries_.clear();
     return;
   }
+  if (is_sorted_) {
+    if (sketch.is_ordered()) {
+      intersect_sorted(std::forward<SS>(sketch));
+      return;
+    }
+    convert_to_hash_table();
+  }
   if (!is_valid_) { // first update, copy or move incoming sketch
     is_valid_ = true;
     const uint8_t lg_size = lg_size_from_count(sketch.get_num_retained(), theta_update_sketch_base<EN, EK, A>::REBUILD_THRESHOLD);
@@ -96,9 +106,65 @@ void theta_intersection_base<EN, EK, P, S, CS, A>::update(SS&& sketch) {
   }
 }
 
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+template<typename SS>
+void theta_intersection_base<EN, EK, P, S, CS, A>::intersect_sorted(SS&& sketch) {
+  if (!is_valid_) { // first update, copy or move incoming sketch
+    is_valid_ = true;
+    sorted_entries_.reserve(sketch.get_num_retained());
+    for (auto& entry: sketch) {
+      if (!sorted_entries_.empty() && !(EK()(sorted_entries_.back()) < EK()(entry))) {
+        throw std::invalid_argument("duplicate or unordered key, possibly corrupted input sketch");
+      }
+      sorted_entries_.push_back(conditional_forward<SS>(entry));
+    }
+    if (sorted_entries_.size() != sketch.get_num_retained()) throw std::invalid_argument("num entries mismatch, possibly corrupted input sketch");
+  } else { // merge-join, matches are compacted in place
+    auto mine = sorted_entries_.begin();
+    auto matched_end = sorted_entries_.begin();
+    uint32_t count = 0;
+    uint64_t previous_hash = 0;
+    for (auto& entry: sketch) {
+      const uint64_t hash = EK()(entry);
+      if (hash >= table_.theta_) break; // early stop
+      if (++count > sketch.get_num_retained()) throw std::invalid_argument(" more keys than expected, possibly corrupted input sketch");
+      if (hash <= previous_hash) throw std::invalid_argument("duplicate or unordered key, possibly corrupted input sketch");
+      previous_hash = hash;
+      mine = gallop_lower_bound<EK>(mine, sorted_entries_.end(), hash);
+      if (mine == sorted_entries_.end()) break;
+      if (EK()(*mine) == hash) {
+        policy_(*mine, conditional_forward<SS>(entry));
+        if (matched_end != mine) *matched_end = std::move(*mine);
+        ++matched_end;
+        ++mine;
+      }
+    }
+    sorted_entries_.erase(matched_end, sorted_entries_.end());
+    if (sorted_entries_.empty() && table_.theta_ == theta_constants::MAX_THETA) table_.is_empty_ = true;
+  }
+}
+
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+void theta_intersection_base<EN, EK, P, S, CS, A>::convert_to_hash_table() {
+  is_sorted_ = false;
+  if (is_valid_) {
+    const uint8_t lg_size = lg_size_from_count(sorted_entries_.size(), theta_update_sketch_base<EN, EK, A>::REBUILD_THRESHOLD);
+    table_ = hash_table(lg_size, lg_size, resize_factor::X1, table_.theta_, table_.seed_, table_.allocator_, table_.is_empty_);
+    for (auto& entry: sorted_entries_) {
+      auto result = table_.find(EK()(entry));
+      table_.insert(result.first, std::move(entry));
+    }
+  }
+  sorted_entries_ = std::vector<EN, A>(table_.allocator_);
+}
+
 template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
 CS theta_intersection_base<EN, EK, P, S, CS, A>::get_result(bool ordered) const {
   if (!is_valid_) throw std::invalid_argument("calling get_result() before calling update() is undefined");
+  if (is_sorted_) {
+    std::vector<EN, A> entries(sorted_entries_);
+    return CS(table_.is_empty_, ordered, compute_seed_hash(table_.seed_), table_.theta_, std::move(entries));
+  }
   std::vector<EN, A> entries(table_.allocator_);
   if (table_.num_entries_ > 0) {
     entries.reserve(table_.num_entries_);
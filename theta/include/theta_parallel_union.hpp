@@ -0,0 +1,54 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#ifndef THETA_PARALLEL_UNION_HPP_
+#define THETA_PARALLEL_UNION_HPP_
+
+#include "theta_union.hpp"
+
+namespace datasketches {
+
+/**
+ * Computes the union of many sketches using multiple threads.
+ * Inputs are handed out to worker threads in small chunks, each worker accumulates
+ * a partial union, and the partial results are merged pairwise in a reduction tree.
+ * All partial unions start from the smallest theta of the non-empty inputs,
+ * so hashes that cannot survive in the result are skipped early
+ * (and the rest of an ordered input is not scanned at all).
+ * The result is a valid union of the inputs, but the retained hashes may differ
+ * from those of a sequential union if the nominal size is exceeded.
+ * Requires linking with a thread library.
+ * @param first random access iterator to the first sketch
+ * @param last random access iterator past the last sketch
+ * @param num_threads maximum number of threads to use, must be positive
+ * @param builder union builder with the parameters of the partial unions
+ * @param ordered optional flag to specify if ordered sketch should be produced
+ * @return the result of the union
+ */
+template<typename Allocator = std::allocator<uint64_t>, typename RandomIt>
+compact_theta_sketch_alloc<Allocator> parallel_union(RandomIt first, RandomIt last, unsigned num_threads,
+    const typename theta_union_alloc<Allocator>::builder& builder = typename theta_union_alloc<Allocator>::builder(),
+    bool ordered = true);
+
+} /* namespace datasketches */
+
+#include "theta_parallel_union_impl.hpp"
+
+#endif
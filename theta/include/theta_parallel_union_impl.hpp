@@ -0,0 +1,95 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#ifndef THETA_PARALLEL_UNION_IMPL_HPP_
+#define THETA_PARALLEL_UNION_IMPL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include "run_threads.hpp"
+
+namespace datasketches {
+
+// non-empty sketch with no entries that lowers theta of a union
+struct theta_only_sketch {
+  uint16_t seed_hash_;
+  uint64_t theta_;
+  bool is_empty() const { return false; }
+  bool is_ordered() const { return true; }
+  uint16_t get_seed_hash() const { return seed_hash_; }
+  uint64_t get_theta64() const { return theta_; }
+  uint32_t get_num_retained() const { return 0; }
+  const uint64_t* begin() const { return nullptr; }
+  const uint64_t* end() const { return nullptr; }
+};
+
+template<typename A, typename RandomIt>
+compact_theta_sketch_alloc<A> parallel_union(RandomIt first, RandomIt last, unsigned num_threads,
+    const typename theta_union_alloc<A>::builder& builder, bool ordered) {
+  if (num_threads == 0) throw std::invalid_argument("number of threads must be positive");
+  const size_t num_sketches = std::distance(first, last);
+  num_threads = static_cast<unsigned>(std::min<size_t>(num_threads, num_sketches));
+  if (num_threads <= 1) {
+    auto u = builder.build();
+    for (auto it = first; it != last; ++it) u.update(*it);
+    return u.get_result(ordered);
+  }
+
+  // theta of the result cannot exceed the smallest theta of a non-empty input
+  theta_only_sketch min_theta_sketch{0, theta_constants::MAX_THETA};
+  for (auto it = first; it != last; ++it) {
+    if (!it->is_empty() && it->get_theta64() < min_theta_sketch.theta_) {
+      min_theta_sketch = theta_only_sketch{it->get_seed_hash(), it->get_theta64()};
+    }
+  }
+
+  // small chunks handed out on demand balance inputs of uneven size
+  const size_t chunk_size = std::max<size_t>(1, num_sketches / (num_threads * 16));
+  std::atomic<size_t> next_chunk(0);
+  std::vector<theta_union_alloc<A>> partials(num_threads, builder.build());
+  run_threads(num_threads, [&](unsigned t) {
+    auto& u = partials[t];
+    if (min_theta_sketch.theta_ < theta_constants::MAX_THETA) u.update(min_theta_sketch);
+    while (true) {
+      const size_t start = next_chunk.fetch_add(chunk_size);
+      if (start >= num_sketches) break;
+      const size_t end = std::min(start + chunk_size, num_sketches);
+      for (size_t i = start; i < end; ++i) u.update(first[i]);
+    }
+  });
+
+  // pairwise reduction of ordered partial results
+  for (unsigned step = 1; step < num_threads; step *= 2) {
+    const unsigned num_merges = (num_threads - step + 2 * step - 1) / (2 * step);
+    run_threads(num_merges, [&](unsigned m) {
+      const unsigned i = m * 2 * step;
+      partials[i].update(partials[i + step].get_result());
+    });
+  }
+  return partials[0].get_result(ordered);
+}
+
+} /* namespace datasketches */
+
+#endif
@@ -137,6 +137,7 @@ protected:
 
 // forward declaration
 template<typename A> class compact_theta_sketch_alloc;
+template<typename A> class wrapped_compact_theta_sketch_alloc;
 
 template<typename Allocator = std::allocator<uint64_t>>
 class update_theta_sketch_alloc: public theta_sketch_alloc<Allocator> {
@@ -264,6 +265,25 @@ public:
    */
   void update(const void* data, size_t length);
 
+  /**
+   * Update this sketch with a batch of unsigned 64-bit integers.
+   * Produces exactly the same result as calling update(uint64_t) for each value in order,
+   * but hashes a block of values and prefetches the hash table slots before inserting,
+   * so that the hashing overlaps with the memory latency of the table lookups.
+   * @param values pointer to the array of values
+   * @param num number of values in the array
+   */
+  void update_batch(const uint64_t* values, size_t num);
+
+  /**
+   * Update this sketch with a batch of strings.
+   * Produces exactly the same result as calling update(const std::string&) for each value in order.
+   * Empty strings are ignored.
+   * @param values pointer to the array of strings
+   * @param num number of strings in the array
+   */
+  void update_batch(const std::string* values, size_t num);
+
   /**
    * Remove retained entries in excess of the nominal size k (if any)
    */
@@ -282,8 +302,13 @@ public:
   virtual const_iterator end() const;
 
 private:
+  // number of items hashed ahead of inserting in update_batch
+  static const size_t BATCH_SIZE = 16;
+
   theta_table table_;
 
+  void insert_batch(const uint64_t* hashes, size_t num);
+
   // for builder
   update_theta_sketch_alloc(uint8_t lg_cur_size, uint8_t lg_nom_size, resize_factor rf, uint64_t theta,
       uint64_t seed, const Allocator& allocator);
@@ -369,6 +394,18 @@ public:
 
 private:
   enum flags { IS_BIG_ENDIAN, IS_READ_ONLY, IS_EMPTY, IS_COMPACT, IS_ORDERED };
+  friend class wrapped_compact_theta_sketch_alloc<Allocator>;
+
+  // checked preamble of a serialized sketch, followed by num_entries hashes starting at entries
+  struct serialized_header {
+    bool is_empty;
+    bool is_ordered;
+    uint16_t seed_hash;
+    uint32_t num_entries;
+    uint64_t theta;
+    const char* entries;
+  };
+  static serialized_header read_header(const void* bytes, size_t size, uint64_t seed);
 
   bool is_empty_;
   bool is_ordered_;
@@ -380,6 +417,81 @@ private:
   virtual void print_specifics(ostrstream& os) const;
 };
 
+// wrapped compact sketch
+
+/**
+ * Read-only view of a serialized compact sketch.
+ * No entries are copied: iteration reads hashes directly from the wrapped buffer,
+ * which must outlive the view and stay unchanged while it is used.
+ * This type can be passed to update() of theta_union and theta_intersection
+ * in place of a deserialized compact sketch.
+ */
+template<typename Allocator = std::allocator<uint64_t>>
+class wrapped_compact_theta_sketch_alloc {
+public:
+  using const_iterator = const uint64_t*;
+
+  bool is_empty() const;
+  bool is_ordered() const;
+  uint64_t get_theta64() const;
+  uint32_t get_num_retained() const;
+  uint16_t get_seed_hash() const;
+
+  /**
+   * @return true if the sketch is in estimation mode (as opposed to exact mode)
+   */
+  bool is_estimation_mode() const;
+
+  /**
+   * @return theta as a fraction from 0 to 1 (effective sampling rate)
+   */
+  double get_theta() const;
+
+  /**
+   * @return estimate of the distinct count of the input stream
+   */
+  double get_estimate() const;
+
+  /**
+   * Returns the approximate lower error bound given a number of standard deviations.
+   * @param num_std_devs number of Standard Deviations (1, 2 or 3)
+   * @return the lower bound
+   */
+  double get_lower_bound(uint8_t num_std_devs) const;
+
+  /**
+   * Returns the approximate upper error bound given a number of standard deviations.
+   * @param num_std_devs number of Standard Deviations (1, 2 or 3)
+   * @return the upper bound
+   */
+  double get_upper_bound(uint8_t num_std_devs) const;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  /**
+   * This method wraps a serialized compact sketch without copying it.
+   * The retained hashes must be 8-byte aligned in memory, which holds if the
+   * sketch starts at an 8-byte aligned address.
+   * @param bytes pointer to the array of bytes
+   * @param size the size of the array
+   * @param seed the seed for the hash function that was used to create the sketch
+   * @return a view of the sketch
+   */
+  static wrapped_compact_theta_sketch_alloc wrap(const void* bytes, size_t size, uint64_t seed = DEFAULT_SEED);
+
+private:
+  bool is_empty_;
+  bool is_ordered_;
+  uint16_t seed_hash_;
+  uint32_t num_entries_;
+  uint64_t theta_;
+  const uint64_t* entries_;
+
+  wrapped_compact_theta_sketch_alloc(bool is_empty, bool is_ordered, uint16_t seed_hash, uint32_t num_entries,
+      uint64_t theta, const uint64_t* entries);
+};
+
 template<typename Allocator>
 class update_theta_sketch_alloc<Allocator>::builder: public theta_base_builder<builder, Allocator> {
 public:
@@ -391,6 +503,7 @@ public:
 using theta_sketch = theta_sketch_alloc<std::allocator<uint64_t>>;
 using update_theta_sketch = update_theta_sketch_alloc<std::allocator<uint64_t>>;
 using compact_theta_sketch = compact_theta_sketch_alloc<std::allocator<uint64_t>>;
+using wrapped_compact_theta_sketch = wrapped_compact_theta_sketch_alloc<std::allocator<uint64_t>>;
 
 } /* namespace datasketches */
 
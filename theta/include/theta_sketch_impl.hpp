@@ -196,6 +196,57 @@ void update_theta_sketch_alloc<A>::update(const void* data, size_t length) {
   }
 }
 
+template<typename A>
+void update_theta_sketch_alloc<A>::update_batch(const uint64_t* values, size_t num) {
+  uint64_t hashes[BATCH_SIZE];
+  while (num > 0) {
+    const size_t block_size = num < BATCH_SIZE ? num : BATCH_SIZE;
+    size_t num_hashes = 0;
+    for (size_t i = 0; i < block_size; ++i) {
+      const uint64_t hash = table_.hash_and_screen(&values[i], sizeof(uint64_t));
+      if (hash != 0) {
+        table_.prefetch(hash);
+        hashes[num_hashes++] = hash;
+      }
+    }
+    insert_batch(hashes, num_hashes);
+    values += block_size;
+    num -= block_size;
+  }
+}
+
+template<typename A>
+void update_theta_sketch_alloc<A>::update_batch(const std::string* values, size_t num) {
+  uint64_t hashes[BATCH_SIZE];
+  while (num > 0) {
+    const size_t block_size = num < BATCH_SIZE ? num : BATCH_SIZE;
+    size_t num_hashes = 0;
+    for (size_t i = 0; i < block_size; ++i) {
+      if (values[i].empty()) continue;
+      const uint64_t hash = table_.hash_and_screen(values[i].c_str(), values[i].length());
+      if (hash != 0) {
+        table_.prefetch(hash);
+        hashes[num_hashes++] = hash;
+      }
+    }
+    insert_batch(hashes, num_hashes);
+    values += block_size;
+    num -= block_size;
+  }
+}
+
+template<typename A>
+void update_theta_sketch_alloc<A>::insert_batch(const uint64_t* hashes, size_t num) {
+  for (size_t i = 0; i < num; ++i) {
+    // theta might have been reduced by a rebuild triggered by a previous insert in this batch
+    if (hashes[i] >= table_.theta_) continue;
+    auto result = table_.find(hashes[i]);
+    if (!result.second) {
+      table_.insert(result.first, hashes[i]);
+    }
+  }
+}
+
 template<typename A>
 void update_theta_sketch_alloc<A>::trim() {
   table_.trim();
@@ -437,6 +488,15 @@ compact_theta_sketch_alloc<A> compact_theta_sketch_alloc<A>::deserialize(std::is
 
 template<typename A>
 compact_theta_sketch_alloc<A> compact_theta_sketch_alloc<A>::deserialize(const void* bytes, size_t size, uint64_t seed, const A& allocator) {
+  const serialized_header header = read_header(bytes, size, seed);
+  std::vector<uint64_t, A> entries(header.num_entries, 0, allocator);
+  if (header.num_entries > 0) copy_from_mem(header.entries, entries.data(), sizeof(uint64_t) * header.num_entries);
+  return compact_theta_sketch_alloc(header.is_empty, header.is_ordered, header.seed_hash, header.theta, std::move(entries));
+}
+
+// shared by deserialize() and wrapped_compact_theta_sketch_alloc::wrap()
+template<typename A>
+auto compact_theta_sketch_alloc<A>::read_header(const void* bytes, size_t size, uint64_t seed) -> serialized_header {
   ensure_minimum_memory(size, 8);
   const char* ptr = static_cast<const char*>(bytes);
   const char* base = ptr;
@@ -463,7 +523,7 @@ compact_theta_sketch_alloc<A> compact_theta_sketch_alloc<A>::deserialize(const v
     if (preamble_longs == 1) {
       num_entries = 1;
     } else {
-      ensure_minimum_memory(size, 8); // read the first prelong before this method
+      ensure_minimum_memory(size, 16);
       ptr += copy_from_mem(ptr, &num_entries, sizeof(num_entries));
       uint32_t unused32;
       ptr += copy_from_mem(ptr, &unused32, sizeof(unused32));
@@ -473,13 +533,94 @@ compact_theta_sketch_alloc<A> compact_theta_sketch_alloc<A>::deserialize(const v
       }
     }
   }
-  const size_t entries_size_bytes = sizeof(uint64_t) * num_entries;
-  check_memory_size(ptr - base + entries_size_bytes, size);
-  std::vector<uint64_t, A> entries(num_entries, 0, allocator);
-  if (!is_empty) ptr += copy_from_mem(ptr, entries.data(), entries_size_bytes);
-
+  check_memory_size(ptr - base + sizeof(uint64_t) * num_entries, size);
   const bool is_ordered = flags_byte & (1 << flags::IS_ORDERED);
-  return compact_theta_sketch_alloc(is_empty, is_ordered, seed_hash, theta, std::move(entries));
+  return serialized_header{is_empty, is_ordered, seed_hash, num_entries, theta, ptr};
+}
+
+// wrapped compact sketch
+
+template<typename A>
+wrapped_compact_theta_sketch_alloc<A>::wrapped_compact_theta_sketch_alloc(bool is_empty, bool is_ordered, uint16_t seed_hash,
+    uint32_t num_entries, uint64_t theta, const uint64_t* entries):
+is_empty_(is_empty),
+is_ordered_(is_ordered),
+seed_hash_(seed_hash),
+num_entries_(num_entries),
+theta_(theta),
+entries_(entries)
+{}
+
+template<typename A>
+bool wrapped_compact_theta_sketch_alloc<A>::is_empty() const {
+  return is_empty_;
+}
+
+template<typename A>
+bool wrapped_compact_theta_sketch_alloc<A>::is_ordered() const {
+  return is_ordered_;
+}
+
+template<typename A>
+uint64_t wrapped_compact_theta_sketch_alloc<A>::get_theta64() const {
+  return theta_;
+}
+
+template<typename A>
+uint32_t wrapped_compact_theta_sketch_alloc<A>::get_num_retained() const {
+  return num_entries_;
+}
+
+template<typename A>
+uint16_t wrapped_compact_theta_sketch_alloc<A>::get_seed_hash() const {
+  return seed_hash_;
+}
+
+template<typename A>
+bool wrapped_compact_theta_sketch_alloc<A>::is_estimation_mode() const {
+  return theta_ < theta_constants::MAX_THETA && !is_empty_;
+}
+
+template<typename A>
+double wrapped_compact_theta_sketch_alloc<A>::get_theta() const {
+  return static_cast<double>(theta_) / theta_constants::MAX_THETA;
+}
+
+template<typename A>
+double wrapped_compact_theta_sketch_alloc<A>::get_estimate() const {
+  return num_entries_ / get_theta();
+}
+
+template<typename A>
+double wrapped_compact_theta_sketch_alloc<A>::get_lower_bound(uint8_t num_std_devs) const {
+  if (!is_estimation_mode()) return num_entries_;
+  return binomial_bounds::get_lower_bound(num_entries_, get_theta(), num_std_devs);
+}
+
+template<typename A>
+double wrapped_compact_theta_sketch_alloc<A>::get_upper_bound(uint8_t num_std_devs) const {
+  if (!is_estimation_mode()) return num_entries_;
+  return binomial_bounds::get_upper_bound(num_entries_, get_theta(), num_std_devs);
+}
+
+template<typename A>
+auto wrapped_compact_theta_sketch_alloc<A>::begin() const -> const_iterator {
+  return entries_;
+}
+
+template<typename A>
+auto wrapped_compact_theta_sketch_alloc<A>::end() const -> const_iterator {
+  return entries_ + num_entries_;
+}
+
+template<typename A>
+wrapped_compact_theta_sketch_alloc<A> wrapped_compact_theta_sketch_alloc<A>::wrap(const void* bytes, size_t size, uint64_t seed) {
+  const auto header = compact_theta_sketch_alloc<A>::read_header(bytes, size, seed);
+  if (header.num_entries > 0 && reinterpret_cast<uintptr_t>(header.entries) % alignof(uint64_t) != 0) {
+    throw std::invalid_argument("retained hashes are not 8-byte aligned, wrap an aligned copy or deserialize instead");
+  }
+  return wrapped_compact_theta_sketch_alloc(header.is_empty, header.is_ordered, header.seed_hash, header.num_entries,
+      header.theta, reinterpret_cast<const uint64_t*>(header.entries));
 }
 
 } /* namespace datasketches */
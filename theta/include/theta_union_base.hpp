@@ -51,6 +51,16 @@ private:
   Policy policy_;
   hash_table table_;
   uint64_t union_theta_;
+  // while all inputs are ordered, the union is kept as a sorted array instead of the hash table
+  bool is_sorted_;
+  std::vector<Entry, Allocator> sorted_entries_;
+  std::vector<Entry, Allocator> merge_buffer_;
+
+  template<typename FwdSketch>
+  void merge_sorted(FwdSketch&& sketch);
+  template<typename FwdSketch, typename Iterator>
+  void insert_into_table(Iterator first, Iterator last, bool is_ordered);
+  void convert_to_hash_table();
 };
 
 } /* namespace datasketches */
@@ -31,7 +31,10 @@ theta_union_base<EN, EK, P, S, CS, A>::theta_union_base(uint8_t lg_cur_size, uin
     uint64_t theta, uint64_t seed, const P& policy, const A& allocator):
 policy_(policy),
 table_(lg_cur_size, lg_nom_size, rf, theta, seed, allocator),
-union_theta_(table_.theta_)
+union_theta_(table_.theta_),
+is_sorted_(true),
+sorted_entries_(allocator),
+merge_buffer_(allocator)
 {}
 
 template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
@@ -41,7 +44,21 @@ void theta_union_base<EN, EK, P, S, CS, A>::update(SS&& sketch) {
   if (sketch.get_seed_hash() != compute_seed_hash(table_.seed_)) throw std::invalid_argument("seed hash mismatch");
   table_.is_empty_ = false;
   if (sketch.get_theta64() < union_theta_) union_theta_ = sketch.get_theta64();
-  for (auto& entry: sketch) {
+  if (is_sorted_) {
+    if (sketch.is_ordered()) {
+      merge_sorted(std::forward<SS>(sketch));
+      return;
+    }
+    convert_to_hash_table();
+  }
+  insert_into_table<SS>(sketch.begin(), sketch.end(), sketch.is_ordered());
+}
+
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+template<typename SS, typename It>
+void theta_union_base<EN, EK, P, S, CS, A>::insert_into_table(It first, It last, bool is_ordered) {
+  for (; first != last; ++first) {
+    auto& entry = *first;
     const uint64_t hash = EK()(entry);
     if (hash < union_theta_) {
       auto result = table_.find(hash);
@@ -51,16 +68,80 @@ void theta_union_base<EN, EK, P, S, CS, A>::update(SS&& sketch) {
         policy_(*result.first, conditional_forward<SS>(entry));
       }
     } else {
-      if (sketch.is_ordered()) break; // early stop
+      if (is_ordered) break; // early stop
     }
   }
   if (table_.theta_ < union_theta_) union_theta_ = table_.theta_;
 }
 
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+template<typename SS>
+void theta_union_base<EN, EK, P, S, CS, A>::merge_sorted(SS&& sketch) {
+  auto theirs = sketch.begin();
+  const auto theirs_end = sketch.end();
+  auto mine = sorted_entries_.begin();
+  auto mine_end = std::lower_bound(sorted_entries_.begin(), sorted_entries_.end(), union_theta_, compare_key_with_value<EK>());
+  if ((theirs == theirs_end || EK()(*theirs) >= union_theta_) && mine_end == sorted_entries_.end()) return; // nothing to merge
+
+  // merge two sorted sequences keeping at most nominal number of entries below theta
+  // runs of own entries between incoming keys are moved in bulk
+  const size_t max_size = (1 << table_.lg_nom_size_) + 1;
+  merge_buffer_.clear();
+  uint64_t previous_key = 0;
+  while (theirs != theirs_end && merge_buffer_.size() < max_size) {
+    const uint64_t key = EK()(*theirs);
+    if (key >= union_theta_) break;
+    if (key <= previous_key) {
+      // flagged as ordered, but not sorted or not unique, possibly corrupted:
+      // switch to the hash table, which deduplicates, and insert the rest of the input there
+      merge_buffer_.insert(merge_buffer_.end(), std::make_move_iterator(mine), std::make_move_iterator(sorted_entries_.end()));
+      std::swap(sorted_entries_, merge_buffer_);
+      merge_buffer_.clear();
+      convert_to_hash_table();
+      insert_into_table<SS>(theirs, theirs_end, false);
+      return;
+    }
+    previous_key = key;
+    const auto run_end = mine + std::min<size_t>(gallop_lower_bound<EK>(mine, mine_end, key) - mine, max_size - merge_buffer_.size());
+    merge_buffer_.insert(merge_buffer_.end(), std::make_move_iterator(mine), std::make_move_iterator(run_end));
+    mine = run_end;
+    if (merge_buffer_.size() == max_size) break;
+    if (mine != mine_end && EK()(*mine) == key) {
+      policy_(*mine, conditional_forward<SS>(*theirs));
+      merge_buffer_.push_back(std::move(*mine));
+      ++mine;
+    } else {
+      merge_buffer_.push_back(conditional_forward<SS>(*theirs));
+    }
+    ++theirs;
+  }
+  const auto rest_end = mine + std::min<size_t>(mine_end - mine, max_size - merge_buffer_.size());
+  merge_buffer_.insert(merge_buffer_.end(), std::make_move_iterator(mine), std::make_move_iterator(rest_end));
+  if (merge_buffer_.size() == max_size) {
+    union_theta_ = EK()(merge_buffer_.back());
+    merge_buffer_.pop_back();
+  }
+  std::swap(sorted_entries_, merge_buffer_);
+}
+
+template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
+void theta_union_base<EN, EK, P, S, CS, A>::convert_to_hash_table() {
+  is_sorted_ = false;
+  for (auto& entry: sorted_entries_) {
+    auto result = table_.find(EK()(entry));
+    table_.insert(result.first, std::move(entry));
+  }
+  sorted_entries_ = std::vector<EN, A>(table_.allocator_);
+}
+
 template<typename EN, typename EK, typename P, typename S, typename CS, typename A>
 CS theta_union_base<EN, EK, P, S, CS, A>::get_result(bool ordered) const {
   std::vector<EN, A> entries(table_.allocator_);
   if (table_.is_empty_) return CS(true, true, compute_seed_hash(table_.seed_), union_theta_, std::move(entries));
+  if (is_sorted_) {
+    entries = sorted_entries_;
+    return CS(false, ordered, compute_seed_hash(table_.seed_), union_theta_, std::move(entries));
+  }
   entries.reserve(table_.num_entries_);
   uint64_t theta = std::min(union_theta_, table_.theta_);
   const uint32_t nominal_num = 1 << table_.lg_nom_size_;
@@ -25,6 +25,7 @@
 #include <cmath>
 
 #include "common_defs.hpp"
+#include "memory_operations.hpp"
 #include "MurmurHash3.h"
 #include "theta_comparators.hpp"
 #include "theta_constants.hpp"
@@ -54,6 +55,9 @@ struct theta_update_sketch_base {
 
   inline std::pair<iterator, bool> find(uint64_t key) const;
 
+  // brings the first slot to be probed by find(key) into cache ahead of time
+  inline void prefetch(uint64_t key) const;
+
   template<typename FwdEntry>
   inline void insert(iterator it, FwdEntry&& entry);
 
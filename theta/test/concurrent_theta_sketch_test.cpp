@@ -0,0 +1,149 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <thread>
+#include <vector>
+
+#include <catch.hpp>
+#include <concurrent_theta_sketch.hpp>
+
+namespace datasketches {
+
+TEST_CASE("concurrent theta sketch: empty", "[concurrent_theta_sketch]") {
+  concurrent_theta_sketch sketch = concurrent_theta_sketch::builder().build();
+  {
+    auto buffer = sketch.get_local_buffer();
+  }
+  REQUIRE(sketch.is_empty());
+  REQUIRE_FALSE(sketch.is_estimation_mode());
+  REQUIRE(sketch.get_theta() == 1.0);
+  REQUIRE(sketch.get_estimate() == 0.0);
+  REQUIRE(sketch.get_lower_bound(1) == 0.0);
+  REQUIRE(sketch.get_upper_bound(1) == 0.0);
+  REQUIRE(sketch.compact().is_empty());
+}
+
+TEST_CASE("concurrent theta sketch: invalid local_lg_k", "[concurrent_theta_sketch]") {
+  REQUIRE_THROWS_AS(concurrent_theta_sketch::builder().set_lg_k(10).set_local_lg_k(11).build(), std::invalid_argument);
+  REQUIRE_THROWS_AS(concurrent_theta_sketch::builder().set_local_lg_k(27), std::invalid_argument);
+  const uint8_t min_local_lg_k = concurrent_theta_sketch::builder::MIN_LOCAL_LG_K;
+  REQUIRE_THROWS_AS(concurrent_theta_sketch::builder().set_local_lg_k(min_local_lg_k - 1), std::invalid_argument);
+  REQUIRE(concurrent_theta_sketch::builder().set_local_lg_k(min_local_lg_k).build().get_local_lg_k() == min_local_lg_k);
+}
+
+TEST_CASE("concurrent theta sketch: buffered until flush", "[concurrent_theta_sketch]") {
+  concurrent_theta_sketch sketch = concurrent_theta_sketch::builder().set_local_lg_k(4).build();
+  auto buffer = sketch.get_local_buffer();
+  for (int i = 0; i < 10; i++) buffer.update(i);
+  REQUIRE(sketch.is_empty());
+  REQUIRE(sketch.get_num_retained() == 0);
+  buffer.flush();
+  REQUIRE_FALSE(sketch.is_empty());
+  REQUIRE(sketch.get_num_retained() == 10);
+  REQUIRE(sketch.get_estimate() == 10.0);
+}
+
+TEST_CASE("concurrent theta sketch: flush on destruction", "[concurrent_theta_sketch]") {
+  concurrent_theta_sketch sketch = concurrent_theta_sketch::builder().build();
+  {
+    auto buffer = sketch.get_local_buffer();
+    for (int i = 0; i < 1000; i++) buffer.update(i);
+  }
+  REQUIRE(sketch.get_estimate() == 1000.0);
+}
+
+TEST_CASE("concurrent theta sketch: exact mode matches update sketch", "[concurrent_theta_sketch]") {
+  update_theta_sketch update_sketch = update_theta_sketch::builder().build();
+  concurrent_theta_sketch sketch = concurrent_theta_sketch::builder().build();
+  auto buffer = sketch.get_local_buffer();
+  for (int i = 0; i < 2000; i++) {
+    update_sketch.update(i);
+    buffer.update(i);
+  }
+  buffer.flush();
+  REQUIRE_FALSE(sketch.is_estimation_mode());
+  compact_theta_sketch compact1 = update_sketch.compact();
+  compact_theta_sketch compact2 = sketch.compact();
+  REQUIRE(compact2.get_num_retained() == compact1.get_num_retained());
+  REQUIRE(compact2.get_seed_hash() == compact1.get_seed_hash());
+  REQUIRE(std::equal(compact1.begin(), compact1.end(), compact2.begin()));
+}
+
+TEST_CASE("concurrent theta sketch: multiple threads disjoint", "[concurrent_theta_sketch]") {
+  concurrent_theta_sketch sketch = concurrent_theta_sketch::builder().build();
+  const int num_threads = 4;
+  const int n = 50000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&sketch, t, n]() {
+      auto buffer = sketch.get_local_buffer();
+      for (int i = 0; i < n; i++) buffer.update(t * n + i);
+      buffer.flush();
+    });
+  }
+  for (auto& thread: threads) thread.join();
+  REQUIRE(sketch.is_estimation_mode());
+  REQUIRE(sketch.get_estimate() == Approx(num_threads * n).margin(num_threads * n * 0.05));
+  compact_theta_sketch compact = sketch.compact();
+  REQUIRE(compact.get_theta64() == sketch.get_theta64());
+  REQUIRE(compact.get_num_retained() == sketch.get_num_retained());
+}
+
+TEST_CASE("concurrent theta sketch: multiple threads same input", "[concurrent_theta_sketch]") {
+  concurrent_theta_sketch sketch = concurrent_theta_sketch::builder().set_local_lg_k(6).build();
+  const int num_threads = 4;
+  const int n = 20000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&sketch, n]() {
+      auto buffer = sketch.get_local_buffer();
+      for (int i = 0; i < n; i++) buffer.update(i);
+      buffer.flush();
+    });
+  }
+  for (auto& thread: threads) thread.join();
+  REQUIRE(sketch.get_estimate() == Approx(n).margin(n * 0.05));
+}
+
+TEST_CASE("concurrent theta sketch: queries while updating", "[concurrent_theta_sketch]") {
+  concurrent_theta_sketch sketch = concurrent_theta_sketch::builder().set_lg_k(9).build();
+  const int num_threads = 2;
+  const int n = 100000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&sketch, t, n]() {
+      auto buffer = sketch.get_local_buffer();
+      for (int i = 0; i < n; i++) buffer.update(t * n + i);
+      buffer.flush();
+    });
+  }
+  // theta and the number of retained entries of each query come from the same propagation,
+  // so the estimate stays within the bounds of the whole input as theta keeps dropping
+  for (int i = 0; i < 10000; i++) {
+    const double estimate = sketch.get_estimate();
+    REQUIRE(estimate >= 0);
+    REQUIRE(estimate < num_threads * n * 1.5);
+    REQUIRE(sketch.get_lower_bound(1) <= sketch.get_upper_bound(1));
+  }
+  for (auto& thread: threads) thread.join();
+  REQUIRE(sketch.get_estimate() == Approx(num_threads * n).margin(num_threads * n * 0.2));
+}
+
+} /* namespace datasketches */
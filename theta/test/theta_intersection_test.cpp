@@ -208,6 +208,84 @@ TEST_CASE("theta intersection: estimation mode disjoint ordered", "[theta_inters
   REQUIRE(result.get_estimate() == 0.0);
 }
 
+TEST_CASE("theta intersection: wrapped compact sketches", "[theta_intersection]") {
+  update_theta_sketch sketch1 = update_theta_sketch::builder().build();
+  int value = 0;
+  for (int i = 0; i < 10000; i++) sketch1.update(value++);
+
+  update_theta_sketch sketch2 = update_theta_sketch::builder().build();
+  value = 5000;
+  for (int i = 0; i < 10000; i++) sketch2.update(value++);
+
+  auto bytes1 = sketch1.compact(false).serialize();
+  auto bytes2 = sketch2.compact().serialize();
+  theta_intersection intersection1;
+  intersection1.update(compact_theta_sketch::deserialize(bytes1.data(), bytes1.size()));
+  intersection1.update(compact_theta_sketch::deserialize(bytes2.data(), bytes2.size()));
+  theta_intersection intersection2;
+  intersection2.update(wrapped_compact_theta_sketch::wrap(bytes1.data(), bytes1.size()));
+  intersection2.update(wrapped_compact_theta_sketch::wrap(bytes2.data(), bytes2.size()));
+  compact_theta_sketch result1 = intersection1.get_result();
+  compact_theta_sketch result2 = intersection2.get_result();
+  REQUIRE(result2.get_theta64() == result1.get_theta64());
+  REQUIRE(result2.get_num_retained() == result1.get_num_retained());
+  REQUIRE(result2.get_estimate() == result1.get_estimate());
+}
+
+TEST_CASE("theta intersection: input flagged as ordered but unsorted", "[theta_intersection]") {
+  update_theta_sketch sketch1 = update_theta_sketch::builder().build();
+  for (int i = 0; i < 1000; i++) sketch1.update(i);
+  update_theta_sketch sketch2 = update_theta_sketch::builder().build();
+  for (int i = 500; i < 1500; i++) sketch2.update(i);
+
+  auto bytes = sketch2.compact(false).serialize();
+  bytes[5] |= 1 << 4; // ordered flag
+  auto mislabelled = wrapped_compact_theta_sketch::wrap(bytes.data(), bytes.size());
+  REQUIRE(mislabelled.is_ordered());
+  theta_intersection intersection;
+  intersection.update(sketch1.compact());
+  REQUIRE_THROWS_AS(intersection.update(mislabelled), std::invalid_argument);
+}
+
+TEST_CASE("theta intersection: ordered and unordered inputs", "[theta_intersection]") {
+  std::vector<update_theta_sketch> sketches;
+  for (int i = 0; i < 4; i++) {
+    sketches.push_back(update_theta_sketch::builder().build());
+    for (int j = 0; j < 20000 - i * 2000; j++) sketches.back().update(i * 1000 + j);
+  }
+
+  // merge-join path, hash table path, and a switch from one to the other
+  theta_intersection intersection1;
+  theta_intersection intersection2;
+  theta_intersection intersection3;
+  for (size_t i = 0; i < sketches.size(); i++) {
+    intersection1.update(sketches[i].compact(true));
+    intersection2.update(sketches[i].compact(false));
+    intersection3.update(sketches[i].compact(i < 2));
+  }
+  compact_theta_sketch result1 = intersection1.get_result();
+  compact_theta_sketch result2 = intersection2.get_result();
+  compact_theta_sketch result3 = intersection3.get_result();
+  REQUIRE(result1.is_estimation_mode());
+  REQUIRE(result1.get_estimate() == Approx(14000).margin(14000 * 0.05));
+  // the same hashes survive regardless of the path
+  REQUIRE(result2.get_theta64() == result1.get_theta64());
+  REQUIRE(result3.get_theta64() == result1.get_theta64());
+  REQUIRE(result2.get_num_retained() == result1.get_num_retained());
+  REQUIRE(result3.get_num_retained() == result1.get_num_retained());
+  auto it = result2.begin();
+  for (auto hash: result1) {
+    REQUIRE(hash == *it);
+    ++it;
+  }
+
+  // disjoint ordered input empties the result
+  update_theta_sketch disjoint = update_theta_sketch::builder().build();
+  for (int j = 0; j < 1000; j++) disjoint.update(100000 + j);
+  intersection1.update(disjoint.compact());
+  REQUIRE(intersection1.get_result().get_num_retained() == 0);
+}
+
 TEST_CASE("theta intersection: seed mismatch", "[theta_intersection]") {
   update_theta_sketch sketch = update_theta_sketch::builder().build();
   sketch.update(1); // non-empty should not be ignored
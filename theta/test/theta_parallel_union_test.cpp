@@ -0,0 +1,134 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <atomic>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <catch.hpp>
+#include <theta_parallel_union.hpp>
+#include <run_threads.hpp>
+
+namespace datasketches {
+
+static std::vector<compact_theta_sketch> make_sketches(int num_sketches, int num_values, int step, float p = 1) {
+  std::vector<compact_theta_sketch> sketches;
+  for (int i = 0; i < num_sketches; ++i) {
+    update_theta_sketch sketch = update_theta_sketch::builder().set_p(p).build();
+    for (int j = 0; j < num_values; ++j) sketch.update(i * step + j);
+    sketches.push_back(sketch.compact(i % 2 == 0));
+  }
+  return sketches;
+}
+
+static compact_theta_sketch sequential_union(const std::vector<compact_theta_sketch>& sketches) {
+  theta_union u = theta_union::builder().build();
+  for (const auto& sketch: sketches) u.update(sketch);
+  return u.get_result();
+}
+
+TEST_CASE("theta parallel union: empty", "[theta_parallel_union]") {
+  std::vector<compact_theta_sketch> sketches;
+  compact_theta_sketch result = parallel_union(sketches.begin(), sketches.end(), 4);
+  REQUIRE(result.is_empty());
+
+  update_theta_sketch empty_sketch = update_theta_sketch::builder().build();
+  for (int i = 0; i < 10; ++i) sketches.push_back(empty_sketch.compact());
+  result = parallel_union(sketches.begin(), sketches.end(), 4);
+  REQUIRE(result.is_empty());
+  REQUIRE(result.get_num_retained() == 0);
+}
+
+TEST_CASE("theta parallel union: invalid number of threads", "[theta_parallel_union]") {
+  auto sketches = make_sketches(4, 10, 10);
+  REQUIRE_THROWS_AS(parallel_union(sketches.begin(), sketches.end(), 0), std::invalid_argument);
+}
+
+TEST_CASE("theta parallel union: exact mode", "[theta_parallel_union]") {
+  // overlapping inputs with 2000 distinct values in total fit into the default nominal size
+  auto sketches = make_sketches(100, 50, 20);
+  compact_theta_sketch expected = sequential_union(sketches);
+  REQUIRE_FALSE(expected.is_estimation_mode());
+  for (unsigned num_threads: {1, 2, 3, 8, 200}) {
+    compact_theta_sketch result = parallel_union(sketches.begin(), sketches.end(), num_threads);
+    REQUIRE_FALSE(result.is_estimation_mode());
+    REQUIRE(result.get_num_retained() == expected.get_num_retained());
+    auto it = expected.begin();
+    for (auto hash: result) {
+      REQUIRE(hash == *it);
+      ++it;
+    }
+  }
+}
+
+TEST_CASE("theta parallel union: estimation mode", "[theta_parallel_union]") {
+  auto sketches = make_sketches(64, 10000, 5000);
+  // inputs with smaller theta must limit the result
+  auto sampled = make_sketches(4, 10000, 5000, 0.5);
+  sketches.insert(sketches.end(), sampled.begin(), sampled.end());
+  compact_theta_sketch expected = sequential_union(sketches);
+  for (unsigned num_threads: {2, 4, 7}) {
+    compact_theta_sketch result = parallel_union(sketches.begin(), sketches.end(), num_threads);
+    REQUIRE(result.is_estimation_mode());
+    REQUIRE(result.is_ordered());
+    REQUIRE(result.get_theta64() <= sampled[0].get_theta64());
+    REQUIRE(result.get_estimate() == Approx(expected.get_estimate()).margin(expected.get_estimate() * 0.05));
+    REQUIRE(result.get_estimate() == Approx(325000).margin(325000 * 0.05));
+  }
+}
+
+TEST_CASE("theta parallel union: update sketches and seed", "[theta_parallel_union]") {
+  const uint64_t seed = 123;
+  std::vector<update_theta_sketch> sketches;
+  for (int i = 0; i < 16; ++i) {
+    sketches.push_back(update_theta_sketch::builder().set_seed(seed).build());
+    for (int j = 0; j < 100; ++j) sketches.back().update(i * 100 + j);
+  }
+  compact_theta_sketch result = parallel_union(sketches.begin(), sketches.end(), 4, theta_union::builder().set_seed(seed));
+  REQUIRE(result.get_estimate() == 1600);
+  REQUIRE_THROWS_AS(parallel_union(sketches.begin(), sketches.end(), 4), std::invalid_argument);
+}
+
+// fails to start the third thread, as std::thread does when the system has no threads left
+class failing_thread {
+public:
+  static int num_started;
+  template<typename F>
+  explicit failing_thread(F&& fn) {
+    if (num_started == 2) throw std::system_error(std::make_error_code(std::errc::resource_unavailable_try_again));
+    thread_ = std::thread(std::forward<F>(fn));
+    ++num_started;
+  }
+  void join() { thread_.join(); }
+private:
+  std::thread thread_;
+};
+int failing_thread::num_started = 0;
+
+TEST_CASE("theta parallel union: thread creation failure", "[theta_parallel_union]") {
+  std::atomic<int> num_finished(0);
+  REQUIRE_THROWS_AS(run_threads<failing_thread>(4, [&num_finished](unsigned) { ++num_finished; }), std::system_error);
+  // the threads started before the failure were joined
+  REQUIRE(num_finished == 2);
+}
+
+} /* namespace datasketches */
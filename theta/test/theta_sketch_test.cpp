@@ -238,4 +238,89 @@ TEST_CASE("theta sketch: deserialize compact single item buffer overrun", "[thet
   REQUIRE_THROWS_AS(compact_theta_sketch::deserialize(bytes.data(), bytes.size() - 1), std::out_of_range);
 }
 
+TEST_CASE("theta sketch: wrap compact empty and single item", "[theta_sketch]") {
+  update_theta_sketch update_sketch = update_theta_sketch::builder().build();
+  auto bytes = update_sketch.compact().serialize();
+  auto wrapped = wrapped_compact_theta_sketch::wrap(bytes.data(), bytes.size());
+  REQUIRE(wrapped.is_empty());
+  REQUIRE(wrapped.get_num_retained() == 0);
+  REQUIRE(wrapped.begin() == wrapped.end());
+
+  update_sketch.update(1);
+  bytes = update_sketch.compact().serialize();
+  wrapped = wrapped_compact_theta_sketch::wrap(bytes.data(), bytes.size());
+  REQUIRE_FALSE(wrapped.is_empty());
+  REQUIRE_FALSE(wrapped.is_estimation_mode());
+  REQUIRE(wrapped.get_estimate() == 1.0);
+  REQUIRE(*wrapped.begin() == *update_sketch.begin());
+  REQUIRE_THROWS_AS(wrapped_compact_theta_sketch::wrap(bytes.data(), bytes.size() - 1), std::out_of_range);
+}
+
+TEST_CASE("theta sketch: wrap compact estimation", "[theta_sketch]") {
+  update_theta_sketch update_sketch = update_theta_sketch::builder().build();
+  const int n = 8192;
+  for (int i = 0; i < n; i++) update_sketch.update(i);
+
+  for (bool ordered: {false, true}) {
+    compact_theta_sketch compact_sketch = update_sketch.compact(ordered);
+    auto bytes = compact_sketch.serialize();
+    auto wrapped = wrapped_compact_theta_sketch::wrap(bytes.data(), bytes.size());
+    REQUIRE_FALSE(wrapped.is_empty());
+    REQUIRE(wrapped.is_ordered() == ordered);
+    REQUIRE(wrapped.is_estimation_mode());
+    REQUIRE(wrapped.get_seed_hash() == compact_sketch.get_seed_hash());
+    REQUIRE(wrapped.get_theta64() == compact_sketch.get_theta64());
+    REQUIRE(wrapped.get_num_retained() == compact_sketch.get_num_retained());
+    REQUIRE(wrapped.get_estimate() == compact_sketch.get_estimate());
+    REQUIRE(wrapped.get_lower_bound(1) == compact_sketch.get_lower_bound(1));
+    REQUIRE(wrapped.get_upper_bound(1) == compact_sketch.get_upper_bound(1));
+    auto iter = compact_sketch.begin();
+    for (auto key: wrapped) {
+      REQUIRE(*iter == key);
+      ++iter;
+    }
+    REQUIRE_THROWS_AS(wrapped_compact_theta_sketch::wrap(bytes.data(), bytes.size(), 123), std::invalid_argument);
+  }
+}
+
+TEST_CASE("theta sketch: batch update equivalence", "[theta_sketch]") {
+  const size_t n = 20000; // goes into estimation mode, so theta changes in the middle of a batch
+  std::vector<uint64_t> values(n);
+  for (size_t i = 0; i < n; i++) values[i] = i;
+
+  update_theta_sketch sketch1 = update_theta_sketch::builder().build();
+  for (uint64_t value: values) sketch1.update(value);
+
+  update_theta_sketch sketch2 = update_theta_sketch::builder().build();
+  sketch2.update_batch(values.data(), 1000);
+  sketch2.update_batch(values.data() + 1000, n - 1000);
+
+  REQUIRE(sketch2.is_estimation_mode());
+  REQUIRE(sketch2.get_theta64() == sketch1.get_theta64());
+  REQUIRE(sketch2.get_num_retained() == sketch1.get_num_retained());
+  compact_theta_sketch compact1 = sketch1.compact();
+  compact_theta_sketch compact2 = sketch2.compact();
+  REQUIRE(std::equal(compact1.begin(), compact1.end(), compact2.begin()));
+}
+
+TEST_CASE("theta sketch: batch update strings", "[theta_sketch]") {
+  std::vector<std::string> values;
+  for (int i = 0; i < 5000; i++) values.push_back(std::to_string(i % 3000));
+  values.push_back("");
+
+  update_theta_sketch sketch1 = update_theta_sketch::builder().build();
+  for (const auto& value: values) sketch1.update(value);
+
+  update_theta_sketch sketch2 = update_theta_sketch::builder().build();
+  sketch2.update_batch(values.data(), values.size());
+
+  REQUIRE(sketch2.get_estimate() == 3000);
+  REQUIRE(sketch2.get_theta64() == sketch1.get_theta64());
+  REQUIRE(sketch2.get_num_retained() == sketch1.get_num_retained());
+
+  update_theta_sketch sketch3 = update_theta_sketch::builder().build();
+  sketch3.update_batch(values.data() + values.size() - 1, 1); // empty string only
+  REQUIRE(sketch3.is_empty());
+}
+
 } /* namespace datasketches */
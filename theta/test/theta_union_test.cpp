@@ -87,6 +87,99 @@ TEST_CASE("theta union: estimation mode half overlap", "[theta_union]") {
   //std::cerr << sketch3.to_string(true);
 }
 
+TEST_CASE("theta union: wrapped compact sketches", "[theta_union]") {
+  update_theta_sketch sketch1 = update_theta_sketch::builder().build();
+  int value = 0;
+  for (int i = 0; i < 10000; i++) sketch1.update(value++);
+
+  update_theta_sketch sketch2 = update_theta_sketch::builder().build();
+  value = 5000;
+  for (int i = 0; i < 10000; i++) sketch2.update(value++);
+
+  auto bytes1 = sketch1.compact().serialize();
+  auto bytes2 = sketch2.compact(false).serialize();
+  theta_union u1 = theta_union::builder().build();
+  u1.update(compact_theta_sketch::deserialize(bytes1.data(), bytes1.size()));
+  u1.update(compact_theta_sketch::deserialize(bytes2.data(), bytes2.size()));
+  theta_union u2 = theta_union::builder().build();
+  u2.update(wrapped_compact_theta_sketch::wrap(bytes1.data(), bytes1.size()));
+  u2.update(wrapped_compact_theta_sketch::wrap(bytes2.data(), bytes2.size()));
+  compact_theta_sketch result1 = u1.get_result();
+  compact_theta_sketch result2 = u2.get_result();
+  REQUIRE(result2.get_theta64() == result1.get_theta64());
+  REQUIRE(result2.get_num_retained() == result1.get_num_retained());
+  REQUIRE(result2.get_estimate() == result1.get_estimate());
+}
+
+TEST_CASE("theta union: input flagged as ordered but unsorted", "[theta_union]") {
+  update_theta_sketch sketch1 = update_theta_sketch::builder().build();
+  for (int i = 0; i < 1000; i++) sketch1.update(i);
+  update_theta_sketch sketch2 = update_theta_sketch::builder().build();
+  for (int i = 500; i < 1500; i++) sketch2.update(i);
+
+  auto bytes = sketch2.compact(false).serialize();
+  bytes[5] |= 1 << 4; // ordered flag
+  auto mislabelled = wrapped_compact_theta_sketch::wrap(bytes.data(), bytes.size());
+  REQUIRE(mislabelled.is_ordered());
+  theta_union u = theta_union::builder().build();
+  u.update(sketch1.compact());
+  u.update(mislabelled);
+  // falls back to the hash table, which deduplicates
+  compact_theta_sketch result = u.get_result();
+  REQUIRE_FALSE(result.is_estimation_mode());
+  REQUIRE(result.get_num_retained() == 1500);
+  uint64_t previous = 0;
+  for (auto hash: result) {
+    REQUIRE(hash > previous);
+    previous = hash;
+  }
+}
+
+TEST_CASE("theta union: ordered and unordered inputs", "[theta_union]") {
+  std::vector<update_theta_sketch> sketches;
+  for (int i = 0; i < 8; i++) {
+    sketches.push_back(update_theta_sketch::builder().build());
+    for (int j = 0; j < 1000 * (i + 1); j++) sketches.back().update(i * 1000 + j);
+  }
+
+  // sorted merge path, hash table path, and a switch from one to the other
+  theta_union u1 = theta_union::builder().build();
+  theta_union u2 = theta_union::builder().build();
+  theta_union u3 = theta_union::builder().build();
+  for (size_t i = 0; i < sketches.size(); i++) {
+    u1.update(sketches[i].compact(true));
+    u2.update(sketches[i].compact(false));
+    u3.update(sketches[i].compact(i < sketches.size() / 2));
+  }
+  compact_theta_sketch result1 = u1.get_result();
+  compact_theta_sketch result2 = u2.get_result();
+  compact_theta_sketch result3 = u3.get_result();
+  REQUIRE(result1.is_estimation_mode());
+  REQUIRE(result1.is_ordered());
+  REQUIRE(result1.get_num_retained() == 4096);
+  REQUIRE(result1.get_estimate() == Approx(15000).margin(15000 * 0.05));
+  REQUIRE(result2.get_estimate() == Approx(result1.get_estimate()).margin(15000 * 0.02));
+  REQUIRE(result3.get_estimate() == Approx(result1.get_estimate()).margin(15000 * 0.02));
+
+  // exact mode must produce identical results
+  theta_union u4 = theta_union::builder().build();
+  theta_union u5 = theta_union::builder().build();
+  for (size_t i = 0; i < 2; i++) {
+    u4.update(sketches[i].compact(true));
+    u5.update(sketches[i].compact(false));
+  }
+  compact_theta_sketch result4 = u4.get_result();
+  compact_theta_sketch result5 = u5.get_result();
+  REQUIRE_FALSE(result4.is_estimation_mode());
+  REQUIRE(result4.get_num_retained() == 3000);
+  REQUIRE(result5.get_num_retained() == 3000);
+  auto it = result5.begin();
+  for (auto hash: result4) {
+    REQUIRE(hash == *it);
+    ++it;
+  }
+}
+
 TEST_CASE("theta union: seed mismatch", "[theta_union]") {
   update_theta_sketch sketch = update_theta_sketch::builder().build();
   sketch.update(1); // non-empty should not be ignored